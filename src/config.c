@@ -35,9 +35,24 @@ static size_t const kMazeHeightMax = 2048;
 static size_t const kMazeHeightDefault = 64;
 static size_t const kMazeHeightMin = 8;
 
+static char const kAlgorithmFlag[] = "--algorithm";
+static mazart_algorithm_t const kAlgorithmDefault = GEN_ALGO_CRAWL;
+static char const kAlgorithmDefaultName[] = "crawl";
+
+static char const kTilesFlag[] = "--tiles";
+static size_t const kTilesMax = 64;
+static size_t const kTilesDefault = 0;
+
+static char const kWorldTileFlag[] = "--world-tile";
+static char const kWorldTile[] = "TX,TY";
+
 static char const kSeedFlag[] = "--seed";
 static char const kSeedDefaultName[] = "time";
 
+static char const kThreadsFlag[] = "--threads";
+static size_t const kThreadsMax = 256;
+static size_t const kThreadsDefault = 0;
+
 static char const kCellWidthFlag[] = "--cell-width";
 static size_t const kCellWidthMax = 64;
 static size_t const kCellWidthDefault = 4;
@@ -59,6 +74,14 @@ static char const kCellColorPaletteOffsetFlag[] = "--cell-palette-offset";
 
 static char const kCellColorPaletteReverseFlag[] = "--cell-palette-reverse";
 
+static char const kOtherSourceFlag[] = "--other-source";
+static char const kOtherSource[] = "ROW,COL";
+
+static char const kOtherSourcesFlag[] = "--other-sources";
+static size_t const kOtherSourcesMin = 1;
+static size_t const kOtherSourcesMax = MAZART_OTHER_SOURCES_MAX;
+static size_t const kOtherSourcesDefault = 8;
+
 static char const kConnColorFlag[] = "--conn-color";
 static mazart_color_t const kConnColorDefault = CLR_LIGHT_GREY;
 static char const kConnColorDefaultName[] = "light-grey";
@@ -89,8 +112,37 @@ static char const kPathColorFlag[] = "--path-color";
 static mazart_color_t const kPathColorDefault = CLR_RED;
 static char const kPathColorDefaultName[] = "red";
 
+static char const kSolverFlag[] = "--solver";
+static mazart_solver_t const kSolverDefault = SOLVER_BIDIRECTIONAL;
+static char const kSolverDefaultName[] = "bidirectional";
+
+static char const kEndpointsFlag[] = "--endpoints";
+static mazart_endpoints_t const kEndpointsDefault = ENDPOINTS_CORNERS;
+static char const kEndpointsDefaultName[] = "corners";
+
+static char const kDistanceEngineFlag[] = "--distance-engine";
+static mazart_distance_engine_t const kDistanceEngineDefault = DIST_ENGINE_QUEUE;
+static char const kDistanceEngineDefaultName[] = "queue";
+
 static char const kOutputFileFlag[] = "--output";
 
+static char const kPathQueriesFlag[] = "--path-queries";
+
+static char const kPathFileFlag[] = "--path-file";
+
+static char const kTileIndexFlag[] = "--tile-index";
+
+static char const kTileIndexSizeFlag[] = "--tile-index-size";
+static size_t const kTileIndexSizeMin = 1;
+static size_t const kTileIndexSizeMax = 255;
+static size_t const kTileIndexSizeDefault = 64;
+
+static char const kMazeFileFlag[] = "--maze-file";
+
+static char const kStatsFileFlag[] = "--stats";
+/* Maze sizes allowed when generating out-of-core. */
+static size_t const kMazeFileSizeMax = 1 << 20;
+
 /* - - Config Consts - - */
 
 #define STR_BUF_SZ 512
@@ -102,6 +154,23 @@ static size_t const kZero = 0; /* User to prevent compiler warnings. */
 static size_t const kFlagIndentSize = 30;
 static size_t const kMaxTermWidth = 120;
 
+static char const kAlgorithm[] = "ALGORITHM";
+typedef struct {
+  kstring_t algorithm_name;
+  mazart_algorithm_t algorithm;
+} known_algorithm_t;
+static known_algorithm_t const kKnownAlgorithms[] = {
+  {"crawl", GEN_ALGO_CRAWL},
+  {"eller", GEN_ALGO_ELLER},
+  {"wilson", GEN_ALGO_WILSON},
+  {"division", GEN_ALGO_DIVISION},
+  {"binary-tree", GEN_ALGO_BINARY_TREE},
+  {"sidewinder", GEN_ALGO_SIDEWINDER},
+  {"backtracker", GEN_ALGO_BACKTRACKER},
+  {"hunt-and-kill", GEN_ALGO_HUNT_AND_KILL}
+};
+static size_t const kKnownAlgorithmsCount = sizeof(kKnownAlgorithms) / sizeof(kKnownAlgorithms[0]);
+
 static char const kColor[] = "COLOR";
 typedef struct {
   kstring_t color_name;
@@ -130,7 +199,13 @@ typedef struct {
 static known_color_metric_t const kKnownColorMetrics[] = {
   {"path", CLR_MTRC_PATH_DIST},
   {"start", CLR_MTRC_START_DIST},
-  {"end", CLR_MTRC_END_DIST}
+  {"end", CLR_MTRC_END_DIST},
+  {"other", CLR_MTRC_OTHER_DIST},
+  {"owner", CLR_MTRC_OTHER_OWNER},
+  {"subtree", CLR_MTRC_SUBTREE},
+  {"branch", CLR_MTRC_BRANCH},
+  {"eccentricity", CLR_MTRC_ECCENTRICITY},
+  {"traffic", CLR_MTRC_TRAFFIC}
 };
 static size_t const kKnownColorMetricCount = sizeof(kKnownColorMetrics) / sizeof(kKnownColorMetrics[0]);
 
@@ -156,8 +231,50 @@ static known_color_method_t kKnownColorMethods[] = {
 };
 static size_t const kKnownColorMethodsCount = sizeof(kKnownColorMethods) / sizeof(kKnownColorMethods[0]);
 
+static char const kSolver[] = "SOLVER";
+typedef struct {
+  kstring_t solver_name;
+  mazart_solver_t solver;
+} known_solver_t;
+static known_solver_t const kKnownSolvers[] = {
+  {"bidirectional", SOLVER_BIDIRECTIONAL},
+  {"bfs", SOLVER_BFS},
+  {"a-star", SOLVER_A_STAR},
+  {"dead-end-fill", SOLVER_DEAD_END_FILL}
+};
+static size_t const kKnownSolversCount = sizeof(kKnownSolvers) / sizeof(kKnownSolvers[0]);
+
+static char const kEndpoints[] = "ENDPOINTS";
+typedef struct {
+  kstring_t endpoints_name;
+  mazart_endpoints_t endpoints;
+} known_endpoints_t;
+static known_endpoints_t const kKnownEndpoints[] = {
+  {"corners", ENDPOINTS_CORNERS},
+  {"diameter", ENDPOINTS_DIAMETER}
+};
+static size_t const kKnownEndpointsCount = sizeof(kKnownEndpoints) / sizeof(kKnownEndpoints[0]);
+
+static char const kDistanceEngine[] = "ENGINE";
+typedef struct {
+  kstring_t distance_engine_name;
+  mazart_distance_engine_t distance_engine;
+} known_distance_engine_t;
+static known_distance_engine_t const kKnownDistanceEngines[] = {
+  {"queue", DIST_ENGINE_QUEUE},
+  {"bit-planes", DIST_ENGINE_BIT_PLANES}
+};
+static size_t const kKnownDistanceEnginesCount = sizeof(kKnownDistanceEngines) / sizeof(kKnownDistanceEngines[0]);
+
 static bool_t IsInteger(char const *value);
 static size_t ParseInteger(char const *value);
+static bool_t IsTileCoordinate(char const *value);
+static void ParseTileCoordinate(char const *value, int64_t *tx, int64_t *ty);
+static bool_t IsCellCoordinate(char const *value);
+static void ParseCellCoordinate(char const *value, point_t *pos);
+static bool_t IsAlgorithm(char const *value);
+static mazart_algorithm_t ParseAlgorithm(char const *value);
+static char const *AlgorithmToString(mazart_algorithm_t algorithm);
 static bool_t IsColor(char const *value);
 static mazart_color_t ParseColor(char const *value);
 static char const *ColorToString(mazart_color_t color);
@@ -170,6 +287,15 @@ static char const *ColorModeToString(mazart_color_mode_t mode);
 static bool_t IsColorMethod(char const *value);
 static mazart_color_method_t  ParseConnColorMethod(char const *value);
 static char const *ColorMethodToString(mazart_color_method_t method);
+static bool_t IsSolver(char const *value);
+static mazart_solver_t ParseSolver(char const *value);
+static char const *SolverToString(mazart_solver_t solver);
+static bool_t IsEndpoints(char const *value);
+static mazart_endpoints_t ParseEndpoints(char const *value);
+static char const *EndpointsToString(mazart_endpoints_t endpoints);
+static bool_t IsDistanceEngine(char const *value);
+static mazart_distance_engine_t ParseDistanceEngine(char const *value);
+static char const *DistanceEngineToString(mazart_distance_engine_t engine);
 static bool_t IsFileName(char const *value);
 static char *ParseFileName(char const *value);
 
@@ -201,6 +327,73 @@ static size_t ParseInteger(char const *value)
   return val;
 }
 
+static bool_t IsTileCoordinate(char const *value)
+{
+  long long tx, ty;
+  char extra;
+  if (!value) return false;
+  return sscanf(value, "%lld,%lld%c", &tx, &ty, &extra) == 2;
+}
+
+static void ParseTileCoordinate(char const *value, int64_t *tx, int64_t *ty)
+{
+  long long x, y;
+  if (sscanf(value, "%lld,%lld", &x, &y) != 2) return;
+  *tx = (int64_t) x;
+  *ty = (int64_t) y;
+}
+
+static bool_t IsCellCoordinate(char const *value)
+{
+  unsigned long row, col;
+  char extra;
+  if (!value || value[0] == '-') return false;
+  return sscanf(value, "%lu,%lu%c", &row, &col, &extra) == 2;
+}
+
+static void ParseCellCoordinate(char const *value, point_t *pos)
+{
+  unsigned long row, col;
+  if (sscanf(value, "%lu,%lu", &row, &col) != 2) return;
+  pos->row = (size_t) row;
+  pos->col = (size_t) col;
+}
+
+static bool_t IsAlgorithm(char const *value)
+{
+  size_t i;
+  if (!value) return false;
+  for (i = 0; i < kKnownAlgorithmsCount; i ++)
+  {
+    if (StringsEqual(value, kKnownAlgorithms[i].algorithm_name))
+      return true;
+  }
+  return false;
+}
+
+static mazart_algorithm_t ParseAlgorithm(char const *value)
+{
+  size_t i;
+  if (!value) return GEN_ALGO_NONE;
+  for (i = 0; i < kKnownAlgorithmsCount; i ++)
+  {
+    if (StringsEqual(value, kKnownAlgorithms[i].algorithm_name))
+      return kKnownAlgorithms[i].algorithm;
+  }
+  return GEN_ALGO_NONE;
+}
+
+static char const *AlgorithmToString(mazart_algorithm_t algorithm)
+{
+  size_t i;
+  for (i = 0; i < kKnownAlgorithmsCount; i ++)
+  {
+    if (kKnownAlgorithms[i].algorithm == algorithm)
+      return kKnownAlgorithms[i].algorithm_name;
+  }
+  return "unknown";
+}
+
 static bool_t IsColor(char const *value)
 {
   size_t i;
@@ -342,6 +535,111 @@ static char const *ColorMethodToString(mazart_color_method_t method)
   return "unknown";
 }
 
+static bool_t IsSolver(char const *value)
+{
+  size_t i;
+  if (!value) return false;
+  for (i = 0; i < kKnownSolversCount; i ++)
+  {
+    if (StringsEqual(value, kKnownSolvers[i].solver_name))
+      return true;
+  }
+  return false;
+}
+
+static mazart_solver_t ParseSolver(char const *value)
+{
+  size_t i;
+  if (!value) return SOLVER_NONE;
+  for (i = 0; i < kKnownSolversCount; i ++)
+  {
+    if (StringsEqual(value, kKnownSolvers[i].solver_name))
+      return kKnownSolvers[i].solver;
+  }
+  return SOLVER_NONE;
+}
+
+static char const *SolverToString(mazart_solver_t solver)
+{
+  size_t i;
+  for (i = 0; i < kKnownSolversCount; i ++)
+  {
+    if (kKnownSolvers[i].solver == solver)
+      return kKnownSolvers[i].solver_name;
+  }
+  return "unknown";
+}
+
+static bool_t IsEndpoints(char const *value)
+{
+  size_t i;
+  if (!value) return false;
+  for (i = 0; i < kKnownEndpointsCount; i ++)
+  {
+    if (StringsEqual(value, kKnownEndpoints[i].endpoints_name))
+      return true;
+  }
+  return false;
+}
+
+static mazart_endpoints_t ParseEndpoints(char const *value)
+{
+  size_t i;
+  if (!value) return ENDPOINTS_NONE;
+  for (i = 0; i < kKnownEndpointsCount; i ++)
+  {
+    if (StringsEqual(value, kKnownEndpoints[i].endpoints_name))
+      return kKnownEndpoints[i].endpoints;
+  }
+  return ENDPOINTS_NONE;
+}
+
+static char const *EndpointsToString(mazart_endpoints_t endpoints)
+{
+  size_t i;
+  for (i = 0; i < kKnownEndpointsCount; i ++)
+  {
+    if (kKnownEndpoints[i].endpoints == endpoints)
+      return kKnownEndpoints[i].endpoints_name;
+  }
+  return "unknown";
+}
+
+static bool_t IsDistanceEngine(char const *value)
+{
+  size_t i;
+  if (!value) return false;
+  for (i = 0; i < kKnownDistanceEnginesCount; i ++)
+  {
+    if (StringsEqual(value, kKnownDistanceEngines[i].distance_engine_name))
+      return true;
+  }
+  return false;
+}
+
+static mazart_distance_engine_t ParseDistanceEngine(char const *value)
+{
+  size_t i;
+  if (!value) return DIST_ENGINE_NONE;
+  for (i = 0; i < kKnownDistanceEnginesCount; i ++)
+  {
+    if (StringsEqual(value, kKnownDistanceEngines[i].distance_engine_name))
+      return kKnownDistanceEngines[i].distance_engine;
+  }
+  return DIST_ENGINE_NONE;
+}
+
+static char const *DistanceEngineToString(mazart_distance_engine_t engine)
+{
+  size_t i;
+  for (i = 0; i < kKnownDistanceEnginesCount; i ++)
+  {
+    if (kKnownDistanceEngines[i].distance_engine == engine)
+      return kKnownDistanceEngines[i].distance_engine_name;
+  }
+  return "unknown";
+}
+
 static bool_t IsFileName(char const *value)
 {
   struct stat s;
@@ -451,18 +749,60 @@ static void PrintUsage(char const *prog)
 
   printf("Required arguments:\n");
   PrintFlag(kOutputFileFlag,
-    "Filepath of output maze PNG file.", "PATHNAME", NULL);
+    "Filepath of output maze PNG file.  Optional with --stats, the "
+    "maze is then not drawn.", "PATHNAME", NULL);
 
   printf("Optional arguments:\n");
   PrintRangedFlag(kMazeWidthFlag, "Number of cells per maze row.", "N",
     kMazeWidthMin, kMazeWidthMax, kMazeWidthDefault);
   PrintRangedFlag(kMazeHeightFlag, "Number of cells per maze column.", "M",
     kMazeHeightMin, kMazeHeightMax, kMazeHeightDefault);
+  PrintFlag(kAlgorithmFlag,
+    "Algorithm used to generate the maze.  "
+    "See below for known algorithms.", kAlgorithm, kAlgorithmDefaultName);
+  PrintRangedFlag(kTilesFlag,
+    "Splits the maze into K x K tiles that are generated in parallel "
+    "with the maze algorithm, then joined.  0 or 1 disables tiling.", "K",
+    0, kTilesMax, kTilesDefault);
+  PrintFlag(kWorldTileFlag,
+    "Generates tile (TX, TY) of an endless maze given by the seed, "
+    "with the maze width and height as the tile size.  Tiles line up "
+    "with their neighbours and show their openings in the border.",
+    kWorldTile, NULL);
+  PrintFlag(kPathQueriesFlag,
+    "File of path queries, one \"row col row col\" pair of cells per "
+    "line.  Each pair is printed with the number of steps between "
+    "them.", "PATHNAME", NULL);
+  PrintFlag(kTileIndexFlag,
+    "Answers the path queries with a hierarchical index of the maze's "
+    "tiles, which is read from this file if it was built for the same "
+    "maze and tile size, and built and saved to it otherwise.",
+    "PATHNAME", NULL);
+  PrintRangedFlag(kTileIndexSizeFlag,
+    "Side of the tiles of a new hierarchical index, in cells.", "N",
+    kTileIndexSizeMin, kTileIndexSizeMax, kTileIndexSizeDefault);
+  PrintFlag(kPathFileFlag,
+    "Saves the solution path to a compact path file, the start cell "
+    "and 2 bits per step.", "PATHNAME", NULL);
+  PrintFlag(kMazeFileFlag,
+    "Generates the maze out-of-core into a compact maze file, which is "
+    "then streamed to the PNG file.  Allows mazes up to 1048576 cells "
+    "wide and high, always uses the eller algorithm and fixed colors.",
+    "PATHNAME", NULL);
+  PrintFlag(kStatsFileFlag,
+    "Saves a JSON report of the maze's statistics: dead ends, junctions "
+    "by degree, corridors by length (bucket k counts corridors of 2^k "
+    "to 2^(k+1) - 1 steps), turns and the solution length.",
+    "PATHNAME", NULL);
 
   PrintFlag(kSeedFlag,
     "Value used to be seed the random number generator used.  "
     "Can be a positive integer or \"time\" to use system time.",
     "SEED", kSeedDefaultName);
+  PrintRangedFlag(kThreadsFlag,
+    "Number of worker threads used by parallel algorithms.  "
+    "0 uses one thread per processor.", "N",
+    0, kThreadsMax, kThreadsDefault);
   PrintRangedFlag(kCellWidthFlag, "Square side-length of maze cell in pixels.",
     "N", kCellWidthMin, kCellWidthMax, kCellWidthDefault);
 
@@ -486,6 +826,14 @@ static void PrintUsage(char const *prog)
   PrintFlag(kCellColorPaletteReverseFlag,
     "Reverses the palette color order.  "
     "Only valid for when using \"palette\" color mode", NULL, NULL);
+  PrintFlag(kOtherSourceFlag,
+    "Adds a source cell of the \"other\" and \"owner\" metrics, "
+    "which color cells by their distance to the nearest source and by "
+    "which source that is.  Can be given several times.",
+    kOtherSource, NULL);
+  PrintRangedFlag(kOtherSourcesFlag,
+    "Number of random source cells, if no source cell is given.", "N",
+    kOtherSourcesMin, kOtherSourcesMax, kOtherSourcesDefault);
 
   PrintFlag(kConnColorFlag,
     "Color of connection between maze cells.  "
@@ -513,11 +861,24 @@ static void PrintUsage(char const *prog)
     kColor, kBorderColorDefaultName);
 
   PrintFlag(kDrawPathFlag,
-    "Draws a solution path from the top right corner to the bottom left.",
+    "Draws a solution path between the maze endpoints.",
     NULL, NULL);
   PrintFlag(kPathColorFlag,
     "Color of the solution path that is drawn.  "
     "Ignored if path drawing is not enabled.", kColor, kPathColorDefaultName);
+  PrintFlag(kSolverFlag,
+    "Method used to find the solution path.  "
+    "See below for known solvers.", kSolver, kSolverDefaultName);
+  PrintFlag(kEndpointsFlag,
+    "Where the maze starts and ends.  "
+    "The corners are the top right and bottom left; the diameter is "
+    "the two cells furthest apart along the maze.  "
+    "See below for known endpoints.", kEndpoints, kEndpointsDefaultName);
+  PrintFlag(kDistanceEngineFlag,
+    "Traversal used for the cell distance metrics.  "
+    "The queue is a threaded breadth-first search; bit-planes floods "
+    "64 cells per word.  See below for known engines.",
+    kDistanceEngine, kDistanceEngineDefaultName);
 
   printf("Developer arguments:\n");
   PrintFlag(kDebugModeFlag,
@@ -526,6 +887,12 @@ static void PrintUsage(char const *prog)
 
   printf("Known values:\n");
 
+  for (i = 0; i < kKnownAlgorithmsCount; i++)
+  {
+    buf[i] = kKnownAlgorithms[i].algorithm_name;
+  }
+  PrintKnownValues(kAlgorithm, buf, kKnownAlgorithmsCount);
+
   for (i = 0; i < kKnownColorsCount; i++)
   {
     buf[i] = kKnownColors[i].color_name;
@@ -549,6 +916,24 @@ static void PrintUsage(char const *prog)
     buf[i] = kKnownColorMethods[i].color_method_name;
   }
   PrintKnownValues(kColorMode, buf, kKnownColorMethodsCount);
+
+  for (i = 0; i < kKnownSolversCount; i++)
+  {
+    buf[i] = kKnownSolvers[i].solver_name;
+  }
+  PrintKnownValues(kSolver, buf, kKnownSolversCount);
+
+  for (i = 0; i < kKnownEndpointsCount; i++)
+  {
+    buf[i] = kKnownEndpoints[i].endpoints_name;
+  }
+  PrintKnownValues(kEndpoints, buf, kKnownEndpointsCount);
+
+  for (i = 0; i < kKnownDistanceEnginesCount; i++)
+  {
+    buf[i] = kKnownDistanceEngines[i].distance_engine_name;
+  }
+  PrintKnownValues(kDistanceEngine, buf, kKnownDistanceEnginesCount);
   printf("\nCopyright (c) 2019 Alex Dale\n");
   printf("This software is distributed under the MIT License\n");
 }
@@ -706,7 +1091,10 @@ void MazartDefaultParameters(mazart_config_t *config)
   memset(config, 0, sizeof(mazart_config_t));
   config->maze_width = kMazeWidthDefault;
   config->maze_height = kMazeHeightDefault;
+  config->algorithm = kAlgorithmDefault;
+  config->tiles = kTilesDefault;
   config->seed = time(NULL);
+  config->threads = kThreadsDefault;
   config->cell_width = kCellWidthDefault;
   config->cell_color = kCellColorDefault;
   config->cell_color_metric = kCellColorMetricDefault;
@@ -718,6 +1106,11 @@ void MazartDefaultParameters(mazart_config_t *config)
   config->border_width = kBorderWidthDefault;
   config->border_color = kBorderColorDefault;
   config->path_color = kPathColorDefault;
+  config->solver = kSolverDefault;
+  config->endpoints = kEndpointsDefault;
+  config->distance_engine = kDistanceEngineDefault;
+  config->tile_index_size = kTileIndexSizeDefault;
+  config->other_random_sources = kOtherSourcesDefault;
 }
 
 void PrintMazartConfit(mazart_config_t *config)
@@ -726,7 +1119,15 @@ void PrintMazartConfit(mazart_config_t *config)
   puts("{");
   printf("  \"maze_width\": %lu,\n", config->maze_width);
   printf("  \"maze_height\": %lu,\n", config->maze_height);
+  printf("  \"algorithm\": \"%s\",\n", AlgorithmToString(config->algorithm));
+  printf("  \"tiles\": %lu,\n", config->tiles);
+  if (config->world_tile)
+  {
+    printf("  \"world_tile\": [%ld, %ld],\n",
+      config->world_tile_x, config->world_tile_y);
+  }
   printf("  \"seed\": %lu,\n", config->seed);
+  printf("  \"threads\": %lu,\n", config->threads);
   printf("  \"cell_width\": %lu,\n", config->cell_width);
   if (config->cell_color != CLR_OTHER && config->cell_color != CLR_NONE)
   {
@@ -737,6 +1138,25 @@ void PrintMazartConfit(mazart_config_t *config)
     printf("  \"cell_color_metric\": \"%s\",\n",
       ColorMetricToString(config->cell_color_metric));
   }
+  if (config->cell_color_metric == CLR_MTRC_OTHER_DIST
+      || config->cell_color_metric == CLR_MTRC_OTHER_OWNER)
+  {
+    if (config->other_source_count > 0)
+    {
+      size_t i;
+      printf("  \"other_sources\": [");
+      for (i = 0; i < config->other_source_count; i++)
+      {
+        printf("%s[%lu, %lu]", i > 0 ? ", " : "",
+          config->other_sources[i].row, config->other_sources[i].col);
+      }
+      printf("],\n");
+    }
+    else
+    {
+      printf("  \"other_random_sources\": %lu,\n", config->other_random_sources);
+    }
+  }
   if (config->cell_color_mode != CLR_MODE_NONE)
   {
     printf("  \"cell_color_mode\": \"%s\",\n",
@@ -772,6 +1192,30 @@ void PrintMazartConfit(mazart_config_t *config)
   {
     printf("  \"path_color\": \"%s\",\n", ColorToString(config->path_color));
   }
+  printf("  \"solver\": \"%s\",\n", SolverToString(config->solver));
+  printf("  \"endpoints\": \"%s\",\n", EndpointsToString(config->endpoints));
+  printf("  \"distance_engine\": \"%s\",\n", DistanceEngineToString(config->distance_engine));
+  if (config->path_queries)
+  {
+    printf("  \"path_queries\": \"%s\",\n", config->path_queries);
+  }
+  if (config->tile_index)
+  {
+    printf("  \"tile_index\": \"%s\",\n", config->tile_index);
+    printf("  \"tile_index_size\": %lu,\n", config->tile_index_size);
+  }
+  if (config->path_file)
+  {
+    printf("  \"path_file\": \"%s\",\n", config->path_file);
+  }
+  if (config->maze_file)
+  {
+    printf("  \"maze_file\": \"%s\",\n", config->maze_file);
+  }
+  if (config->stats_file)
+  {
+    printf("  \"stats_file\": \"%s\",\n", config->stats_file);
+  }
   if (config->output_file)
   {
     printf("  \"output_file\": \"%s\"\n", config->output_file);
@@ -807,6 +1251,22 @@ void PrintMazartConfit(mazart_config_t *config)
 #define GET_INTEGER_MAX(arg, value, name, max) GET_INTEGER_MAX_MIN(arg, value, name, max, kZero)
 #define GET_INTEGER(arg, value, name) GET_INTEGER_MAX(arg, value, name, SIZE_MAX)
 
+#define GET_ALGORITHM(arg, value, name) ({ \
+  mazart_algorithm_t a; \
+  if (!value) { \
+    fprintf(stderr, "Error: Expected algorithm after %s\n", arg); \
+    return false; \
+  } \
+  if (!IsAlgorithm(value)) { \
+    fprintf(stderr, \
+      "Error: Expected algorithm after %s, got %s; " \
+      "see --help for available algorithms\n", arg, value); \
+    return false; \
+  } \
+  a = ParseAlgorithm(value); \
+  a; \
+})
+
 #define GET_COLOR(arg, value, name) ({ \
   mazart_color_t c; \
   if (!value) { \
@@ -871,6 +1331,54 @@ void PrintMazartConfit(mazart_config_t *config)
   c; \
 })
 
+#define GET_SOLVER(arg, value, name) ({ \
+  mazart_solver_t s; \
+  if (!value) { \
+    fprintf(stderr, "Error: Expected solver after %s\n", arg); \
+    return false; \
+  } \
+  if (!IsSolver(value)) { \
+    fprintf(stderr, \
+      "Error: Expected solver after %s, got %s; " \
+      "see --help for available solvers\n", arg, value); \
+    return false; \
+  } \
+  s = ParseSolver(value); \
+  s; \
+})
+
+#define GET_ENDPOINTS(arg, value, name) ({ \
+  mazart_endpoints_t e; \
+  if (!value) { \
+    fprintf(stderr, "Error: Expected endpoints after %s\n", arg); \
+    return false; \
+  } \
+  if (!IsEndpoints(value)) { \
+    fprintf(stderr, \
+      "Error: Expected endpoints after %s, got %s; " \
+      "see --help for available endpoints\n", arg, value); \
+    return false; \
+  } \
+  e = ParseEndpoints(value); \
+  e; \
+})
+
+#define GET_DISTANCE_ENGINE(arg, value, name) ({ \
+  mazart_distance_engine_t e; \
+  if (!value) { \
+    fprintf(stderr, "Error: Expected distance engine after %s\n", arg); \
+    return false; \
+  } \
+  if (!IsDistanceEngine(value)) { \
+    fprintf(stderr, \
+      "Error: Expected distance engine after %s, got %s; " \
+      "see --help for available engines\n", arg, value); \
+    return false; \
+  } \
+  e = ParseDistanceEngine(value); \
+  e; \
+})
+
 #define VAL_CONTINUE i++; continue;
 
 bool_t ParseMazartParameters(char const * const *args, size_t arg_count, mazart_config_t *config)
@@ -902,13 +1410,36 @@ bool_t ParseMazartParameters(char const * const *args, size_t arg_count, mazart_
     if (StringsEqual(arg, kMazeWidthFlag))
     {
       config->maze_width =
-        GET_INTEGER_MAX_MIN(arg, value, kMazeWidthFlag, kMazeWidthMax, kMazeWidthMin);
+        GET_INTEGER_MAX_MIN(arg, value, kMazeWidthFlag, kMazeFileSizeMax, kMazeWidthMin);
       VAL_CONTINUE;
     }
     if (StringsEqual(arg, kMazeHeightFlag))
     {
       config->maze_height =
-        GET_INTEGER_MAX_MIN(arg, value, kMazeHeightFlag, kMazeHeightMax, kMazeHeightMin);
+        GET_INTEGER_MAX_MIN(arg, value, kMazeHeightFlag, kMazeFileSizeMax, kMazeHeightMin);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kAlgorithmFlag))
+    {
+      config->algorithm =
+        GET_ALGORITHM(arg, value, kAlgorithmFlag);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kTilesFlag))
+    {
+      config->tiles =
+        GET_INTEGER_MAX(arg, value, kTilesFlag, kTilesMax);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kWorldTileFlag))
+    {
+      if (!IsTileCoordinate(value))
+      {
+        fprintf(stderr, "Error: Expected %s after %s\n", kWorldTile, arg);
+        return false;
+      }
+      config->world_tile = true;
+      ParseTileCoordinate(value, &config->world_tile_x, &config->world_tile_y);
       VAL_CONTINUE;
     }
     if (StringsEqual(arg, kSeedFlag))
@@ -918,6 +1449,12 @@ bool_t ParseMazartParameters(char const * const *args, size_t arg_count, mazart_
       config->seed = GET_INTEGER(arg, value, kSeedFlag);
       VAL_CONTINUE;
     }
+    if (StringsEqual(arg, kThreadsFlag))
+    {
+      config->threads =
+        GET_INTEGER_MAX(arg, value, kThreadsFlag, kThreadsMax);
+      VAL_CONTINUE;
+    }
     if (StringsEqual(arg, kCellWidthFlag))
     {
       config->cell_width =
@@ -936,6 +1473,29 @@ bool_t ParseMazartParameters(char const * const *args, size_t arg_count, mazart_
         GET_COLOR_METRIC(arg, value, kCellColorMetricFlag);
       VAL_CONTINUE
     }
+    if (StringsEqual(arg, kOtherSourceFlag))
+    {
+      if (!IsCellCoordinate(value))
+      {
+        fprintf(stderr, "Error: Expected %s after %s\n", kOtherSource, arg);
+        return false;
+      }
+      if (config->other_source_count == MAZART_OTHER_SOURCES_MAX)
+      {
+        fprintf(stderr, "Error: At most %d %s can be given\n",
+          MAZART_OTHER_SOURCES_MAX, arg);
+        return false;
+      }
+      ParseCellCoordinate(value, &config->other_sources[config->other_source_count++]);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kOtherSourcesFlag))
+    {
+      config->other_random_sources =
+        GET_INTEGER_MAX_MIN(arg, value, kOtherSourcesFlag,
+          kOtherSourcesMax, kOtherSourcesMin);
+      VAL_CONTINUE;
+    }
     if (StringsEqual(arg, kCellColorModeFlag))
     {
       config->cell_color_mode =
@@ -1000,6 +1560,24 @@ bool_t ParseMazartParameters(char const * const *args, size_t arg_count, mazart_
         GET_COLOR(arg, value, kPathColorFlag);
       VAL_CONTINUE;
     }
+    if (StringsEqual(arg, kSolverFlag))
+    {
+      config->solver =
+        GET_SOLVER(arg, value, kSolverFlag);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kEndpointsFlag))
+    {
+      config->endpoints =
+        GET_ENDPOINTS(arg, value, kEndpointsFlag);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kDistanceEngineFlag))
+    {
+      config->distance_engine =
+        GET_DISTANCE_ENGINE(arg, value, kDistanceEngineFlag);
+      VAL_CONTINUE;
+    }
     if (StringsEqual(arg, kOutputFileFlag))
     {
       if (!IsFileName(value)) return false;
@@ -1011,6 +1589,63 @@ bool_t ParseMazartParameters(char const * const *args, size_t arg_count, mazart_
       config->output_file = ParseFileName(value);
       VAL_CONTINUE;
     }
+    if (StringsEqual(arg, kPathQueriesFlag))
+    {
+      if (!IsFileName(value)) return false;
+      if (config->path_queries)
+      {
+        free((void*)config->path_queries);
+      }
+      config->path_queries = ParseFileName(value);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kTileIndexFlag))
+    {
+      if (!IsFileName(value)) return false;
+      if (config->tile_index)
+      {
+        free((void*)config->tile_index);
+      }
+      config->tile_index = ParseFileName(value);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kTileIndexSizeFlag))
+    {
+      config->tile_index_size =
+        GET_INTEGER_MAX_MIN(arg, value, kTileIndexSizeFlag,
+          kTileIndexSizeMax, kTileIndexSizeMin);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kPathFileFlag))
+    {
+      if (!IsFileName(value)) return false;
+      if (config->path_file)
+      {
+        free((void*)config->path_file);
+      }
+      config->path_file = ParseFileName(value);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kMazeFileFlag))
+    {
+      if (!IsFileName(value)) return false;
+      if (config->maze_file)
+      {
+        free((void*)config->maze_file);
+      }
+      config->maze_file = ParseFileName(value);
+      VAL_CONTINUE;
+    }
+    if (StringsEqual(arg, kStatsFileFlag))
+    {
+      if (!IsFileName(value)) return false;
+      if (config->stats_file)
+      {
+        free((void*)config->stats_file);
+      }
+      config->stats_file = ParseFileName(value);
+      VAL_CONTINUE;
+    }
     fprintf(stderr, "Error: unknown argument %s\n", arg);
     PrintUsage(prog);
     return false;
@@ -1036,11 +1671,44 @@ bool_t ParseMazartParameters(char const * const *args, size_t arg_count, mazart_
     fprintf(stderr, "Warning: %s has not effect if color mode is not palette\n",
       kCellColorPaletteOffsetFlag);
   }
-  if (!config->output_file)
+  if (!config->output_file && (!config->stats_file || config->maze_file))
   {
     fprintf(stderr, "Error: %s is required\n", kOutputFileFlag);
     return false;
   }
+  if (!config->maze_file && config->maze_width > kMazeWidthMax)
+  {
+    fprintf(stderr, "Error: Max value for %s is %lu without %s, got %lu\n",
+      kMazeWidthFlag, kMazeWidthMax, kMazeFileFlag, config->maze_width);
+    return false;
+  }
+  if (!config->maze_file && config->maze_height > kMazeHeightMax)
+  {
+    fprintf(stderr, "Error: Max value for %s is %lu without %s, got %lu\n",
+      kMazeHeightFlag, kMazeHeightMax, kMazeFileFlag, config->maze_height);
+    return false;
+  }
+  for (i = 0; i < config->other_source_count; i++)
+  {
+    if (config->other_sources[i].row >= config->maze_height
+        || config->other_sources[i].col >= config->maze_width)
+    {
+      fprintf(stderr, "Error: %s %lu,%lu is outside the %lu x %lu maze\n",
+        kOtherSourceFlag, config->other_sources[i].row,
+        config->other_sources[i].col, config->maze_width, config->maze_height);
+      return false;
+    }
+  }
+  if (config->maze_file &&
+      (config->cell_color_mode != CLR_MODE_NONE || config->draw_path
+       || config->world_tile || config->tiles > 1 || config->path_file
+       || config->stats_file
+       || (config->algorithm != GEN_ALGO_ELLER && config->algorithm != kAlgorithmDefault)))
+  {
+    fprintf(stderr,
+      "Warning: %s always uses the eller algorithm, and ignores tiles, "
+      "world tiles, color metrics, the solution path and statistics\n", kMazeFileFlag);
+  }
   return true;
 }
 
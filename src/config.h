@@ -13,6 +13,9 @@
 #include "common.h"
 #include "color.h"
 
+/* Most cells that can be given as sources of the "other" metrics. */
+#define MAZART_OTHER_SOURCES_MAX 256
+
 typedef enum {
   CLR_NONE,
   /* Grey scale. */
@@ -32,12 +35,29 @@ typedef enum {
   CLR_OTHER
 } mazart_color_t;
 
+typedef enum {
+  GEN_ALGO_NONE,
+  GEN_ALGO_CRAWL,
+  GEN_ALGO_ELLER,
+  GEN_ALGO_WILSON,
+  GEN_ALGO_DIVISION,
+  GEN_ALGO_BINARY_TREE,
+  GEN_ALGO_SIDEWINDER,
+  GEN_ALGO_BACKTRACKER,
+  GEN_ALGO_HUNT_AND_KILL
+} mazart_algorithm_t;
+
 typedef enum {
   CLR_MTRC_NONE,
   CLR_MTRC_PATH_DIST,
   CLR_MTRC_START_DIST,
   CLR_MTRC_END_DIST,
-  CLR_MTRC_OTHER_DIST
+  CLR_MTRC_OTHER_DIST,
+  CLR_MTRC_OTHER_OWNER,
+  CLR_MTRC_SUBTREE,
+  CLR_MTRC_BRANCH,
+  CLR_MTRC_ECCENTRICITY,
+  CLR_MTRC_TRAFFIC
 } mazart_color_metric_t;
 
 typedef enum {
@@ -53,14 +73,42 @@ typedef enum {
   CLR_MTHD_AVERAGE
 } mazart_color_method_t;
 
+typedef enum {
+  SOLVER_NONE,
+  SOLVER_BIDIRECTIONAL,
+  SOLVER_BFS,
+  SOLVER_A_STAR,
+  SOLVER_DEAD_END_FILL
+} mazart_solver_t;
+
+typedef enum {
+  ENDPOINTS_NONE,
+  ENDPOINTS_CORNERS,
+  ENDPOINTS_DIAMETER
+} mazart_endpoints_t;
+
+typedef enum {
+  DIST_ENGINE_NONE,
+  DIST_ENGINE_QUEUE,
+  DIST_ENGINE_BIT_PLANES
+} mazart_distance_engine_t;
+
 typedef struct {
   /* Generic parameters. */
   bool_t debug_mode;
   /* Maze parameters. */
   size_t maze_width;
   size_t maze_height;
+  mazart_algorithm_t algorithm;
+  size_t tiles;
+  /* Endless maze tile, the maze size is the tile size. */
+  bool_t world_tile;
+  int64_t world_tile_x;
+  int64_t world_tile_y;
   /* Randomizer config. */
   size_t seed;
+  /* Worker threads, 0 for one per processor. */
+  size_t threads;
   /* Image settings. */
   /* Cell settings. */
   size_t cell_width;
@@ -69,6 +117,11 @@ typedef struct {
   mazart_color_mode_t cell_color_mode;
   size_t cell_color_palette_offset;
   bool_t cell_color_palette_reverse;
+  /* Sources of the "other" metrics, the given cells or, if there are
+   * none, a number of random cells. */
+  point_t other_sources[MAZART_OTHER_SOURCES_MAX];
+  size_t other_source_count;
+  size_t other_random_sources;
   /* Conn color settings. */
   mazart_color_t conn_color;
   mazart_color_method_t conn_color_method;
@@ -81,8 +134,23 @@ typedef struct {
   /* Solution path. */
   bool_t draw_path;
   mazart_color_t path_color;
+  mazart_solver_t solver;
+  mazart_endpoints_t endpoints;
+  /* Cell distance metric traversal. */
+  mazart_distance_engine_t distance_engine;
   /* Output file. */
   char const *output_file;
+  /* Path queries file, answered on standard output. */
+  char const *path_queries;
+  /* Hierarchical index file for the path queries, and its tile size. */
+  char const *tile_index;
+  size_t tile_index_size;
+  /* Compact path file the solution path is saved to. */
+  char const *path_file;
+  /* Out-of-core maze file, if set the maze is generated into it. */
+  char const *maze_file;
+  /* Maze statistics report file, JSON. */
+  char const *stats_file;
 } mazart_config_t;
 
 void MazartDefaultParameters(mazart_config_t *config);
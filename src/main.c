@@ -7,18 +7,33 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 #include "colorer.h"
 #include "common.h"
 #include "config.h"
-#include "deque.h"
 #include "maze.h"
+#include "maze_distance.h"
+#include "maze_file.h"
+#include "maze_graph.h"
+#include "maze_hier.h"
 #include "maze_image.h"
+#include "maze_index.h"
+#include "maze_path.h"
+#include "maze_solve.h"
+#include "maze_stats.h"
+#include "maze_tree.h"
+#include "maze_world.h"
+#include "thread_pool.h"
 
 static maze_property_t const kPathDistanceProperty = 1;
 static maze_property_t const kStartDistanceProperty = 2;
 static maze_property_t const kEndDistanceProperty = 3;
+static maze_property_t const kOtherDistanceProperty = 4;
+static maze_property_t const kOtherOwnerProperty = 5;
+/* Only the tree metric being colored is filled, so they share. */
+static maze_property_t const kTreeMetricProperty = 6;
 
 static rgb_t const kPresetAStartColor = {.red = 255, .green = 127, .blue = 0};
 static rgb_t const kPresetAEndColor = {.red = 127, .green = 0, .blue = 127};
@@ -27,146 +42,105 @@ typedef struct {
   int64_t path_max;
   int64_t start_max;
   int64_t end_max;
+  int64_t other_max;
+  int64_t owner_max;
+  int64_t tree_max;
 } mazart_maxes_t;
 
-static int64_t CountDistanceFromPath(maze_t const *maze, point_t *path, size_t path_length)
+/* Wall-clock seconds since `since`, which counts time spent by every
+ * thread only once. */
+static double SecondsSince(struct timespec const *since)
 {
-  point_t pos;
-  point_t poss[4];
-  size_t height, width, i, j, n;
-  int64_t dist, max_dist;
-  maze_cell_t *cell, *next_cell;
-  maze_cell_pair_t *conn;
-  deque_t *conn_queue;
-  if (!maze || !path || path_length == 0) return -1;
-  height = MazeHeight(maze);
-  width = MazeWidth(maze);
-  /* Clear path distance data */
-  for (pos.row = 0; pos.row < height; pos.row++)
-  for (pos.col = 0; pos.col < width; pos.col++)
-  {
-    cell = GetMazeCell(maze, &pos);
-    if (!cell) continue;
-    SetMazeCellProperty(cell, kPathDistanceProperty, 0);
-  }
-  /* Initalize all the cells on the path. */
-  for (i = 0; i < path_length; i++)
-  {
-    cell = GetMazeCell(maze, &path[i]);
-    if (!cell) continue;
-    SetMazeCellProperty(cell, kPathDistanceProperty, 1);
-  }
-  /* Queue all the neighbours of the path for processing. */
-  conn_queue = CreateDeque();
-  for (i = 0; i < path_length; i++)
-  {
-    cell = GetMazeCell(maze, &path[i]);
-    if (!cell) continue;
-    n = GetMazeCellNeighbourPoints(cell, poss);
-    for (j = 0; j < n; j++)
-    {
-      next_cell = GetMazeCell(maze, &poss[j]);
-      if (!next_cell) continue;
-      /* Skip nodes on the path */
-      if (GetMazeCellProperty(next_cell, kPathDistanceProperty) == 1) continue;
-      conn = CreateMazeCellPair(cell, next_cell);
-      PushDequeLast(conn_queue, conn);
-    }
+  struct timespec now;
+  timespec_get(&now, TIME_UTC);
+  return ((double) (now.tv_sec - since->tv_sec))
+    + ((double) (now.tv_nsec - since->tv_nsec)) / 1e9;
+}
+
+/* Fills the path, start and end distance properties of every cell. */
+static void FindMazeDistancesFromConfig(
+  mazart_config_t const *config, maze_t const *maze, maze_path_t const *path,
+  point_t const *start, point_t const *end, mazart_maxes_t *maxes)
+{
+  maze_dist_request_t request;
+  int64_t field_maxes[MAZE_DIST_FIELD_COUNT];
+  memset(&request, 0, sizeof(maze_dist_request_t));
+  request.fields = MAZE_DIST_ALL_FIELDS;
+  request.engine = config->distance_engine == DIST_ENGINE_BIT_PLANES
+    ? MAZE_DIST_ENGINE_BIT_PLANES : MAZE_DIST_ENGINE_QUEUE;
+  request.properties[MAZE_DIST_PATH] = kPathDistanceProperty;
+  request.properties[MAZE_DIST_START] = kStartDistanceProperty;
+  request.properties[MAZE_DIST_END] = kEndDistanceProperty;
+  request.path = path;
+  request.start = *start;
+  request.end = *end;
+  FillMazeDistances(maze, &request, field_maxes);
+  maxes->path_max = field_maxes[MAZE_DIST_PATH];
+  maxes->start_max = field_maxes[MAZE_DIST_START];
+  maxes->end_max = field_maxes[MAZE_DIST_END];
+}
+
+/* Fills the distance to, and owner of, the nearest "other" source of
+ * every cell, from the given sources or random ones. */
+static void FindOtherRegionsFromConfig(
+  mazart_config_t const *config, maze_t const *maze, mazart_maxes_t *maxes)
+{
+  point_t random_sources[MAZART_OTHER_SOURCES_MAX];
+  point_t const *sources;
+  size_t count, i;
+  if (config->other_source_count > 0)
+  {
+    sources = config->other_sources;
+    count = config->other_source_count;
   }
-  max_dist = 1;
-  while (DequeSize(conn_queue) > 0)
+  else
   {
-    conn = PopDequeFirst(conn_queue);
-    cell = conn->src;
-    next_cell = conn->dest;
-    FreeMazeCellPair(conn);
-    /* Set distance */
-    dist = GetMazeCellProperty(cell, kPathDistanceProperty) + 1;
-    if (dist > max_dist)
-    {
-      max_dist = dist;
-    }
-    SetMazeCellProperty(next_cell, kPathDistanceProperty, dist);
-    /* Queue all neightbours */
-    cell = next_cell;
-    n = GetMazeCellNeighbourPoints(cell, poss);
-    for (i = 0; i < n; i++)
+    count = config->other_random_sources;
+    for (i = 0; i < count; i++)
     {
-      next_cell = GetMazeCell(maze, &poss[i]);
-      if (!next_cell) continue;
-      /* Skip nodes on the path */
-      if (GetMazeCellProperty(next_cell, kPathDistanceProperty) > 0) continue;
-      conn = CreateMazeCellPair(cell, next_cell);
-      PushDequeLast(conn_queue, conn);
+      random_sources[i].row = (size_t) rand() % MazeHeight(maze);
+      random_sources[i].col = (size_t) rand() % MazeWidth(maze);
     }
+    sources = random_sources;
+  }
+  maxes->owner_max = (int64_t) count;
+  if (!FillMazeSourceRegions(maze, sources, count,
+      kOtherDistanceProperty, kOtherOwnerProperty, &maxes->other_max))
+  {
+    fprintf(stderr, "Warning: Sources of the other metric must be inside the maze\n");
   }
-  FreeDeque(conn_queue);
-  return max_dist;
 }
 
-static int64_t CountDistanceFromSource(maze_t const *maze, point_t const *source_pos, maze_property_t property)
+/* Fills the colored tree metric of every cell, rooted at `root`. */
+static void FindTreeMetricFromConfig(
+  mazart_config_t const *config, maze_t const *maze, point_t const *root,
+  mazart_maxes_t *maxes)
 {
-  point_t pos;
-  point_t poss[4];
-  size_t height, width, i, n;
-  int64_t dist, max_dist;
-  maze_cell_t *cell, *next_cell;
-  maze_cell_pair_t *conn;
-  deque_t *conn_queue;
-  if (!maze || !source_pos) return -1;
-  height = MazeHeight(maze);
-  width = MazeWidth(maze);
-  /* Clear cell distance data */
-  for (pos.row = 0; pos.row < height; pos.row++)
-  for (pos.col = 0; pos.col < width; pos.col++)
-  {
-    cell = GetMazeCell(maze, &pos);
-    if (!cell) continue;
-    SetMazeCellProperty(cell, property, 0);
-  }
-  /* Initalize First */
-  cell = GetMazeCell(maze, source_pos);
-  if (!cell) return -1;
-  SetMazeCellProperty(cell, property, 1);
-  /* Queue first set of neighbours. */
-  conn_queue = CreateDeque();
-  n = GetMazeCellNeighbourPoints(cell, poss);
-  for (i = 0; i < n; i++)
-  {
-    next_cell = GetMazeCell(maze, &poss[i]);
-    if (!next_cell) return -1;
-    conn = CreateMazeCellPair(cell, next_cell);
-    PushDequeLast(conn_queue, conn);
-  }
-  max_dist = 1;
-  while (DequeSize(conn_queue) > 0)
-  {
-    conn = PopDequeFirst(conn_queue);
-    cell = conn->src;
-    next_cell = conn->dest;
-    FreeMazeCellPair(conn);
-    /* Set distance */
-    dist = GetMazeCellProperty(cell, property) + 1;
-    if (dist > max_dist)
-    {
-      max_dist = dist;
-    }
-    SetMazeCellProperty(next_cell, property, dist);
-    /* Queue all neightbours */
-    cell = next_cell;
-    n = GetMazeCellNeighbourPoints(cell, poss);
-    for (i = 0; i < n; i++)
-    {
-      next_cell = GetMazeCell(maze, &poss[i]);
-      if (!next_cell) continue;
-      /* Skip nodes on the path */
-      if (GetMazeCellProperty(next_cell, property) > 0) continue;
-      conn = CreateMazeCellPair(cell, next_cell);
-      PushDequeLast(conn_queue, conn);
-    }
+  maze_tree_request_t request;
+  maze_tree_metric_t metric;
+  int64_t metric_maxes[MAZE_TREE_METRIC_COUNT];
+  switch (config->cell_color_metric)
+  {
+    case CLR_MTRC_SUBTREE:
+      metric = MAZE_TREE_SUBTREE;
+      break;
+    case CLR_MTRC_BRANCH:
+      metric = MAZE_TREE_BRANCH;
+      break;
+    case CLR_MTRC_ECCENTRICITY:
+      metric = MAZE_TREE_ECCENTRICITY;
+      break;
+    case CLR_MTRC_TRAFFIC:
+    default:
+      metric = MAZE_TREE_TRAFFIC;
+      break;
   }
-  FreeDeque(conn_queue);
-  return max_dist;
+  memset(&request, 0, sizeof(maze_tree_request_t));
+  request.metrics = MazeTreeMetricMask(metric);
+  request.properties[metric] = kTreeMetricProperty;
+  request.root = *root;
+  FillMazeTreeMetrics(maze, &request, metric_maxes);
+  maxes->tree_max = metric_maxes[metric];
 }
 
 static colorer_ctx_t *CreateColorerContextFromConfig(mazart_config_t const *config, mazart_maxes_t const *maxes)
@@ -190,8 +164,20 @@ static colorer_ctx_t *CreateColorerContextFromConfig(mazart_config_t const *conf
       max = maxes->end_max;
       break;
     case CLR_MTRC_OTHER_DIST:
-      fprintf(stderr, "Warning: Cell \"other\" metric is not supported\n");
-      return NULL;
+      property = kOtherDistanceProperty;
+      max = maxes->other_max;
+      break;
+    case CLR_MTRC_OTHER_OWNER:
+      property = kOtherOwnerProperty;
+      max = maxes->owner_max;
+      break;
+    case CLR_MTRC_SUBTREE:
+    case CLR_MTRC_BRANCH:
+    case CLR_MTRC_ECCENTRICITY:
+    case CLR_MTRC_TRAFFIC:
+      property = kTreeMetricProperty;
+      max = maxes->tree_max;
+      break;
     default:
       return NULL;
   }
@@ -254,20 +240,265 @@ static void ConvertConfigToMazeStartEnd(mazart_config_t const *config, point_t *
   }
 }
 
+static maze_algorithm_t ConvertConfigToMazeAlgorithm(mazart_config_t const *config)
+{
+  switch (config->algorithm)
+  {
+    case GEN_ALGO_ELLER:
+      return MAZE_ALGO_ELLER;
+    case GEN_ALGO_WILSON:
+      return MAZE_ALGO_WILSON;
+    case GEN_ALGO_DIVISION:
+      return MAZE_ALGO_DIVISION;
+    case GEN_ALGO_BINARY_TREE:
+      return MAZE_ALGO_BINARY_TREE;
+    case GEN_ALGO_SIDEWINDER:
+      return MAZE_ALGO_SIDEWINDER;
+    case GEN_ALGO_BACKTRACKER:
+      return MAZE_ALGO_BACKTRACKER;
+    case GEN_ALGO_HUNT_AND_KILL:
+      return MAZE_ALGO_HUNT_AND_KILL;
+    case GEN_ALGO_CRAWL:
+    case GEN_ALGO_NONE:
+    default:
+      return MAZE_ALGO_CRAWL;
+  }
+}
+
+static void ConvertConfigToMazeWorld(mazart_config_t const *config, maze_world_t *world)
+{
+  world->seed = config->seed;
+  world->tile_height = config->maze_height;
+  world->tile_width = config->maze_width;
+  world->algorithm = ConvertConfigToMazeAlgorithm(config);
+}
+
 static maze_t *CreateMazeFromConfig(mazart_config_t const *config)
 {
   point_t start, end;
+  maze_world_t world;
   if (!config) return NULL;
+  if (config->world_tile)
+  {
+    ConvertConfigToMazeWorld(config, &world);
+    return CreateWorldTileMaze(&world, config->world_tile_x, config->world_tile_y);
+  }
   ConvertConfigToMazeStartEnd(config, &start, &end);
-  return CreateMaze(config->maze_height, config->maze_width, &start, &end);
+  return CreateTiledMaze(config->maze_height, config->maze_width,
+    &start, &end, ConvertConfigToMazeAlgorithm(config), config->tiles);
+}
+
+/* Solves the maze from `start` to `end` with the config's solver. */
+static maze_path_t *SolveMazeFromConfig(
+  mazart_config_t const *config, maze_t const *maze,
+  point_t const *start, point_t const *end)
+{
+  maze_search_stats_t stats;
+  maze_path_t *path;
+  maze_graph_t *graph;
+  point_t *points;
+  size_t length, filled;
+  memset(&stats, 0, sizeof(maze_search_stats_t));
+  switch (config->solver)
+  {
+    case SOLVER_BFS:
+    case SOLVER_A_STAR:
+      /* Ask for the length first, so the points are exactly sized. */
+      if (config->solver == SOLVER_BFS)
+        length = SolveMazeBfs(maze, start, end, NULL, 0, &stats);
+      else
+        length = SolveMazeAStar(maze, start, end, NULL, 0, &stats);
+      points = calloc(length, sizeof(point_t));
+      if (config->solver == SOLVER_BFS)
+        SolveMazeBfs(maze, start, end, points, length, NULL);
+      else
+        SolveMazeAStar(maze, start, end, points, length, NULL);
+      path = CreateMazePathFromPoints(points, length);
+      free(points);
+      break;
+    case SOLVER_DEAD_END_FILL:
+      path = SolveMazeDeadEndFill(maze, start, end, &filled);
+      if (config->debug_mode)
+      {
+        printf("Dead-end filling filled %lu cells\n", filled);
+        graph = CreateMazeGraph(maze, (point_t[]) {*start, *end}, 2);
+        printf("Corridor graph has %lu nodes and %lu corridors\n",
+          MazeGraphNodeCount(graph), MazeGraphEdgeCount(graph));
+        FreeMazeGraph(graph);
+      }
+      return path;
+    case SOLVER_BIDIRECTIONAL:
+    case SOLVER_NONE:
+    default:
+      path = SolveMazePath(maze, start, end, &stats);
+      break;
+  }
+  if (config->debug_mode)
+  {
+    printf("Path search visited %lu cells, expanded %lu, max frontier %lu\n",
+      stats.visited, stats.expanded, stats.max_frontier);
+  }
+  return path;
+}
+
+/* Reads the config's hierarchical index, or builds and saves it if it
+ * does not match the maze and tile size. */
+static maze_hier_index_t *LoadMazeHierIndexFromConfig(mazart_config_t const *config, maze_t const *maze)
+{
+  maze_hier_index_t *index;
+  struct timespec timer;
+  timespec_get(&timer, TIME_UTC);
+  index = ReadMazeHierIndexFile(maze, config->tile_index_size, config->tile_index);
+  if (index)
+  {
+    if (config->debug_mode) printf("Tile index read in %.3f seconds\n", SecondsSince(&timer));
+    return index;
+  }
+  index = CreateMazeHierIndex(maze, config->tile_index_size);
+  if (config->debug_mode)
+  {
+    printf("Tile index built in %.3f seconds, %lu entrances\n",
+      SecondsSince(&timer), MazeHierIndexEntranceCount(index));
+  }
+  if (!WriteMazeHierIndexFile(index, config->tile_index))
+  {
+    fprintf(stderr, "Error: Failed to write tile index %s\n", config->tile_index);
+  }
+  return index;
+}
+
+/* Answers the config's path queries file on standard output. */
+static bool_t AnswerPathQueriesFromConfig(mazart_config_t const *config, maze_t const *maze)
+{
+  maze_path_index_t *index;
+  maze_hier_index_t *hier;
+  FILE *queries;
+  struct timespec timer;
+  size_t count;
+  queries = fopen(config->path_queries, "r");
+  if (!queries)
+  {
+    fprintf(stderr, "Error: Failed to open path queries %s\n", config->path_queries);
+    return false;
+  }
+  if (config->tile_index)
+  {
+    hier = LoadMazeHierIndexFromConfig(config, maze);
+    timespec_get(&timer, TIME_UTC);
+    count = AnswerMazeHierQueries(hier, queries, stdout);
+    if (config->debug_mode)
+    {
+      printf("Answered %lu path queries in %.3f seconds\n", count, SecondsSince(&timer));
+    }
+    FreeMazeHierIndex(hier);
+    fclose(queries);
+    return true;
+  }
+  timespec_get(&timer, TIME_UTC);
+  index = CreateMazePathIndex(maze);
+  if (config->debug_mode) printf("Path index built in %.3f seconds\n", SecondsSince(&timer));
+  timespec_get(&timer, TIME_UTC);
+  count = AnswerMazePathQueries(index, queries, stdout);
+  if (config->debug_mode)
+  {
+    printf("Answered %lu path queries in %.3f seconds\n", count, SecondsSince(&timer));
+  }
+  FreeMazePathIndex(index);
+  fclose(queries);
+  return true;
+}
+
+/* Counts the maze's statistics and saves them to the config's stats
+ * file as JSON. */
+static bool_t WriteMazeStatsFromConfig(
+  mazart_config_t const *config, maze_t const *maze, maze_path_t const *path)
+{
+  maze_stats_t stats;
+  FILE *file;
+  size_t i, buckets;
+  struct timespec timer;
+  timespec_get(&timer, TIME_UTC);
+  FindMazeStats(maze, path, &stats);
+  if (config->debug_mode) printf("Statistics found in %.3f seconds\n", SecondsSince(&timer));
+  file = fopen(config->stats_file, "w");
+  if (!file)
+  {
+    fprintf(stderr, "Error: Failed to write stats file %s\n", config->stats_file);
+    return false;
+  }
+  buckets = MAZE_STATS_CORRIDOR_BUCKETS;
+  while (buckets > 0 && stats.corridor_lengths[buckets - 1] == 0) buckets--;
+  fprintf(file, "{\n");
+  fprintf(file, "  \"seed\": %lu,\n", config->seed);
+  fprintf(file, "  \"maze_width\": %lu,\n", MazeWidth(maze));
+  fprintf(file, "  \"maze_height\": %lu,\n", MazeHeight(maze));
+  fprintf(file, "  \"cells\": %lu,\n", stats.cells);
+  fprintf(file, "  \"passages\": %lu,\n", stats.passages);
+  fprintf(file, "  \"closed_cells\": %lu,\n", stats.degrees[0]);
+  fprintf(file, "  \"dead_ends\": %lu,\n", stats.degrees[1]);
+  fprintf(file, "  \"junctions\": {\"3\": %lu, \"4\": %lu},\n",
+    stats.degrees[3], stats.degrees[4]);
+  fprintf(file, "  \"straights\": %lu,\n", stats.straights);
+  fprintf(file, "  \"turns\": %lu,\n", stats.turns);
+  fprintf(file, "  \"turn_ratio\": %.6f,\n",
+    stats.degrees[2] ? (double) stats.turns / (double) stats.degrees[2] : 0.0);
+  fprintf(file, "  \"corridors\": %lu,\n", stats.corridors);
+  fprintf(file, "  \"longest_corridor\": %lu,\n", stats.longest_corridor);
+  fprintf(file, "  \"corridor_lengths\": [");
+  for (i = 0; i < buckets; i++)
+  {
+    fprintf(file, i ? ", %lu" : "%lu", stats.corridor_lengths[i]);
+  }
+  fprintf(file, "],\n");
+  fprintf(file, "  \"solution_length\": %lu\n", stats.solution_length);
+  fprintf(file, "}\n");
+  fclose(file);
+  return true;
+}
+
+/* Generates the maze out-of-core into the config's maze file, then
+ * streams the file to the PNG output. */
+static bool_t ExportMazeFileFromConfig(mazart_config_t const *config)
+{
+  maze_image_config_t img_config;
+  maze_file_t *file;
+  struct timespec timer;
+  if (config->debug_mode) printf("Creating maze file %s...\n", config->maze_file);
+  timespec_get(&timer, TIME_UTC);
+  if (!GenerateMazeFile(config->maze_file,
+      config->maze_height, config->maze_width, config->seed))
+  {
+    fprintf(stderr, "Error: Failed to write maze file %s\n", config->maze_file);
+    return false;
+  }
+  if (config->debug_mode) printf("Maze file created in %.3f seconds\n", SecondsSince(&timer));
+  file = OpenMazeFile(config->maze_file);
+  if (!file)
+  {
+    fprintf(stderr, "Error: Failed to read maze file %s\n", config->maze_file);
+    return false;
+  }
+  DefaultMazeImageConfig(&img_config);
+  img_config.cell_width = config->cell_width;
+  img_config.wall_width = config->wall_width;
+  img_config.border_width = config->border_width;
+  MazartColorToColor(config->cell_color, &img_config.default_cell_color);
+  MazartColorToColor(config->conn_color, &img_config.default_conn_color);
+  MazartColorToColor(config->wall_color, &img_config.wall_color);
+  MazartColorToColor(config->border_color, &img_config.border_color);
+  if (config->debug_mode) printf("Exporting maze file to %s...\n", config->output_file);
+  ExportMazeFileToPNG(file, &img_config, config->output_file);
+  CloseMazeFile(file);
+  return true;
 }
 
 int main(int argc, char **argv)
 {
   point_t start, end;
-  point_t *path = NULL;
-  size_t path_length;
+  maze_path_t *path;
   mazart_maxes_t maxes;
+  size_t diameter;
+  struct timespec timer;
   maze_t *maze;
   maze_image_t *image;
   maze_image_config_t img_config;
@@ -278,49 +509,139 @@ int main(int argc, char **argv)
     return EXIT_FAILURE;
   }
   printf("Generating %lu x %lu maze, saving to %s\n",
-    config.maze_width, config.maze_height, config.output_file);
+    config.maze_width, config.maze_height,
+    config.output_file ? config.output_file : config.stats_file);
   if (config.debug_mode) PrintMazartConfit(&config);
 
   if (config.debug_mode) printf("Applying seed %lu\n", config.seed);
   srand(config.seed);
+  SetDefaultThreadCount(config.threads);
+
+  if (config.maze_file)
+  {
+    return ExportMazeFileFromConfig(&config) ? 0 : EXIT_FAILURE;
+  }
 
   if (config.debug_mode) printf("Creating Maze...\n");
+  timespec_get(&timer, TIME_UTC);
   maze = CreateMazeFromConfig(&config);
+  if (config.debug_mode) printf("Maze created in %.3f seconds\n", SecondsSince(&timer));
+
+  if (config.endpoints == ENDPOINTS_DIAMETER)
+  {
+    if (config.debug_mode) printf("Finding maze diameter...\n");
+    timespec_get(&timer, TIME_UTC);
+    diameter = FindMazeDiameter(maze, &start, &end);
+    SetMazeEndpoints(maze, &start, &end);
+    if (config.debug_mode)
+    {
+      printf("Maze diameter is %lu steps, found in %.3f seconds\n",
+        diameter, SecondsSince(&timer));
+    }
+  }
 
   if (config.debug_mode) printf("Computing maze path...\n");
-  ConvertConfigToMazeStartEnd(&config, &start, &end);
-  path = calloc(config.maze_width * config.maze_height + 1, sizeof(point_t));
-  path_length = ComputeMazePath(maze,
-    &start, &end,
-    path, config.maze_width * config.maze_height + 1);
-  if (config.debug_mode) printf("Path found, length = %lu\n", path_length);
+  MazeStart(maze, &start);
+  MazeEnd(maze, &end);
+  path = SolveMazeFromConfig(&config, maze, &start, &end);
+  if (config.debug_mode) printf("Path found, length = %lu\n", MazePathLength(path));
+
+  if (config.path_file)
+  {
+    if (config.debug_mode) printf("Saving solution path to %s...\n", config.path_file);
+    if (!WriteMazePathFile(path, config.path_file))
+    {
+      fprintf(stderr, "Error: Failed to write path file %s\n", config.path_file);
+    }
+  }
+
+  if (config.path_queries)
+  {
+    if (config.debug_mode) printf("Answering path queries...\n");
+    AnswerPathQueriesFromConfig(&config, maze);
+  }
+
+  if (config.stats_file)
+  {
+    if (config.debug_mode) printf("Saving statistics to %s...\n", config.stats_file);
+    WriteMazeStatsFromConfig(&config, maze, path);
+  }
+
+  if (!config.output_file)
+  {
+    FreeMazePath(path);
+    FreeMaze(maze);
+    return 0;
+  }
 
-  if (config.debug_mode) printf("Finding max path distance...\n");
-  maxes.path_max = CountDistanceFromPath(maze, path, path_length);
-  if (config.debug_mode) printf("Max distance from path is %ld\n", maxes.path_max);
+  if (config.debug_mode) printf("Finding distances from path, start and end...\n");
+  timespec_get(&timer, TIME_UTC);
+  FindMazeDistancesFromConfig(&config, maze, path, &start, &end, &maxes);
+  if (config.debug_mode)
+  {
+    printf("Distances found in %.3f seconds\n", SecondsSince(&timer));
+    printf("Max distance from path is %ld\n", maxes.path_max);
+    printf("Max distance from start is %ld\n", maxes.start_max);
+    printf("Max distance from end is %ld\n", maxes.end_max);
+  }
 
-  if (config.debug_mode) printf("Finding max distance from start...\n");
-  maxes.start_max = CountDistanceFromSource(maze, &start, kStartDistanceProperty);
-  if (config.debug_mode) printf("Max distance from start is %ld\n", maxes.start_max);
+  maxes.other_max = maxes.owner_max = -1;
+  if (config.cell_color_metric == CLR_MTRC_OTHER_DIST
+      || config.cell_color_metric == CLR_MTRC_OTHER_OWNER)
+  {
+    if (config.debug_mode) printf("Finding regions of the other sources...\n");
+    timespec_get(&timer, TIME_UTC);
+    FindOtherRegionsFromConfig(&config, maze, &maxes);
+    if (config.debug_mode)
+    {
+      printf("Regions found in %.3f seconds\n", SecondsSince(&timer));
+      printf("Max distance from other sources is %ld\n", maxes.other_max);
+    }
+  }
 
-  if (config.debug_mode) printf("Finding max distance from end...\n");
-  maxes.end_max = CountDistanceFromSource(maze, &end, kEndDistanceProperty);
-  if (config.debug_mode) printf("Max distance from end is %ld\n", maxes.end_max);
+  maxes.tree_max = -1;
+  if (config.cell_color_metric == CLR_MTRC_SUBTREE
+      || config.cell_color_metric == CLR_MTRC_BRANCH
+      || config.cell_color_metric == CLR_MTRC_ECCENTRICITY
+      || config.cell_color_metric == CLR_MTRC_TRAFFIC)
+  {
+    if (config.debug_mode) printf("Finding tree metric...\n");
+    timespec_get(&timer, TIME_UTC);
+    FindTreeMetricFromConfig(&config, maze, &start, &maxes);
+    if (config.debug_mode)
+    {
+      printf("Tree metric found in %.3f seconds\n", SecondsSince(&timer));
+      printf("Max tree metric is %ld\n", maxes.tree_max);
+    }
+  }
 
   if (config.debug_mode) printf("Converting maze to image...\n");
   ConvertConfigToMazeImageConfig(&config, &img_config, &maxes);
   image = CreateMazeImage(maze, &img_config);
 
+  if (config.world_tile)
+  {
+    maze_world_t world;
+    point_t openings[MAZE_DIR_COUNT];
+    size_t d;
+    ConvertConfigToMazeWorld(&config, &world);
+    GetWorldTileOpenings(&world, config.world_tile_x, config.world_tile_y, openings);
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      OpenMazeImageBorder(image, maze, &openings[d], (maze_dir_t) d);
+    }
+  }
+
   if (config.draw_path)
   {
     if (config.debug_mode) printf("Drawing solution path...\n");
-    DrawPathOnMazeImage(image, path, path_length, NULL);
+    DrawMazePathOnMazeImage(image, path, NULL);
   }
 
   if (config.debug_mode) printf("Exporting maze to %s...\n", config.output_file);
   ExportMazeImageToPNG(image, config.output_file);
 
-  free(path);
+  FreeMazePath(path);
   FreeColorerContext(img_config.cell_color_ctx);
   FreeMazeImage(image);
   FreeMaze(maze);
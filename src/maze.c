@@ -12,22 +12,81 @@
 #include <string.h>
 
 #include "grid.h"
+#include "maze_backtrack.h"
+#include "maze_division.h"
+#include "maze_eller.h"
+#include "maze_hunt.h"
+#include "maze_packed.h"
+#include "maze_tiled.h"
+#include "maze_wilson.h"
 #include "priority.h"
 
 /* - - Maze Structure - - */
 
 struct maze_st {
   grid_t *grid;
+  maze_conn_t *conns; /* [row * width + col] */
   point_t start;
   point_t end;
+  maze_algorithm_t algorithm;
+  size_t tiles;       /* Drawn as tiles x tiles tiles if more than 1. */
+  bool_t seeded;      /* Draws from `rng` instead of rand(). */
+  rng_t rng;
+  /* Origin shift state, parents is NULL until the first shift. */
+  uint8_t *parents;   /* Maze Direction to parent [row * width + col] */
+  point_t origin;
+};
+
+/* Resumable state of the crawl drawing. */
+typedef struct {
+  priority_queue_t *queue;
+  maze_cell_t *current;   /* NULL once the crawl is done. */
+} crawl_state_t;
+
+/* Resumable state of the Eller drawing, which generates a row at a
+ * time and draws its connections one by one. */
+typedef struct {
+  eller_gen_t *gen;       /* NULL unless drawing with Eller. */
+  maze_conn_t *row;       /* Connections of the last generated row. */
+  size_t rows;            /* Rows generated so far. */
+  size_t next;            /* Next connection of the row, 2 per column. */
+} eller_state_t;
+
+/* - - Maze Generator Structure - - */
+
+struct maze_gen_st {
+  maze_t *maze;
+  size_t edges;
+  bool_t done;
+  /* Algorithm state, only one is used. */
+  crawl_state_t crawl;
+  eller_state_t eller;
+  wilson_gen_t *wilson;
+  backtrack_gen_t *backtrack;
+  hunt_gen_t *hunt;
 };
 
 /* - - Maze Internal API Prototypes - - */
 
+/* Allocates a Maze and its Maze Cells, without drawing it. */
+static maze_t *AllocateMaze(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm);
 /* Creates the connections between cells. */
 static void DrawMaze(maze_t *maze);
+/* Crawl drawing, can be stopped after any number of connections. */
+static void StartMazeCrawl(maze_t *maze, crawl_state_t *crawl);
+static size_t StepMazeCrawl(maze_t *maze, crawl_state_t *crawl, size_t max_edges);
+static void StopMazeCrawl(crawl_state_t *crawl);
+/* Eller drawing, can be stopped after any number of connections. */
+static void StartMazeEller(maze_t *maze, eller_state_t *eller);
+static size_t StepMazeEller(maze_t *maze, eller_state_t *eller, size_t max_edges);
+static bool_t IsMazeEllerDone(maze_t const *maze, eller_state_t const *eller);
+static void StopMazeEller(eller_state_t *eller);
 /* Removes all connections between cells. */
 static void ClearMazeConnections(maze_t *maze);
+/* Builds the parent direction of every cell, rooted at the origin. */
+static void BuildMazeParents(maze_t *maze);
 /* Clears all Maze Cell's `visited` flag. */
 static void ClearMazeVisitedFlags(maze_t *maze);
 
@@ -35,11 +94,8 @@ static void ClearMazeVisitedFlags(maze_t *maze);
 
 struct maze_cell_st {
   point_t pos;
-  /* Neighbours */
-  maze_cell_t *up;
-  maze_cell_t *down;
-  maze_cell_t *left;
-  maze_cell_t *right;
+  /* Owning Maze, neighbours are found in its connections. */
+  maze_t const *maze;
   /* Flags */
   bool_t flags[MAX_MAZE_FLAG];
   /* Properties */
@@ -51,41 +107,57 @@ struct maze_cell_st {
 /* - - Maze Cell Internal API Prototypes - - */
 
 /* Maze Cell constructor. */
-static maze_cell_t *CreateMazeCell(point_t const *pos);
+static maze_cell_t *CreateMazeCell(maze_t const *maze, point_t const *pos);
 /* Maze Cell destructor. */
 static void FreeMazeCell(maze_cell_t *cell);
 /* Special destructor signature used for ClearGridDestroyCells(). */
 static void FreeVoidMazeCell(void *cell) { FreeMazeCell((maze_cell_t*) cell); }
+/* Special destructor signature used for ClearPriorityQueueDestroyItems(). */
+static void FreeVoidMazeCellPair(void *pair) { FreeMazeCellPair((maze_cell_pair_t*) pair); }
 
 #define visit(c) (c)->visited = true
 /* Creates a bi-directional connection between two given cells. */
-static void ConnectMazeCells(maze_cell_t *a, maze_cell_t *b);
+static void ConnectMazeCells(maze_t *maze, maze_cell_t *a, maze_cell_t *b);
 
 /* - - Maze API - - */
 
 maze_t *CreateMaze(size_t height, size_t width, point_t const *start, point_t const *end)
+{
+  return CreateMazeWithAlgorithm(height, width, start, end, MAZE_ALGO_CRAWL);
+}
+
+maze_t *CreateMazeWithAlgorithm(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm)
 {
   maze_t *maze;
-  point_t p;
-  if (!start || !end) return NULL;
-  if (height == 0 || width == 0) return NULL;
-  /* Enforce start end bounds. */
-  if (width <= start->col || width <= end->col) return NULL;
-  if (height <= start->row || height <= end->row) return NULL;
-  /* Create Maze struct. */
-  maze = (maze_t*)calloc(1, sizeof(maze_t));
-  /* Create Grid for storing Maze Cells. */
-  maze->grid = CreateGrid(height, width);
-  maze->start = *start;
-  maze->end = *end;
-  /* Creates a new Maze Cell for every point.  */
-  for (p.row = 0; p.row < height; p.row++)
-  {
-    for (p.col = 0; p.col < width; p.col++)
-    {
-      SetGridCell(maze->grid, &p, CreateMazeCell(&p));
-    }
-  }
+  maze = AllocateMaze(height, width, start, end, algorithm);
+  if (!maze) return NULL;
+  DrawMaze(maze);
+  return maze;
+}
+
+maze_t *CreateSeededMaze(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm, uint64_t seed)
+{
+  maze_t *maze;
+  maze = AllocateMaze(height, width, start, end, algorithm);
+  if (!maze) return NULL;
+  maze->seeded = true;
+  SeedRng(&maze->rng, seed);
+  DrawMaze(maze);
+  return maze;
+}
+
+maze_t *CreateTiledMaze(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm, size_t tiles)
+{
+  maze_t *maze;
+  maze = AllocateMaze(height, width, start, end, algorithm);
+  if (!maze) return NULL;
+  maze->tiles = tiles;
   DrawMaze(maze);
   return maze;
 }
@@ -95,6 +167,8 @@ void FreeMaze(maze_t *maze)
   if (!maze) return;
   ClearGridDestroyCells(maze->grid, FreeVoidMazeCell);
   FreeGrid(maze->grid);
+  free(maze->conns);
+  free(maze->parents);
   memset(maze, 0, sizeof(maze_t));
   free(maze);
 }
@@ -105,6 +179,8 @@ void ReDrawMaze(maze_t *maze, point_t const *start, point_t const *end)
   ClearMazeConnections(maze);
   if (start) maze->start = *start;
   if (end) maze->end = *end;
+  free(maze->parents);
+  maze->parents = NULL;
   DrawMaze(maze);
 }
 
@@ -134,6 +210,41 @@ void MazeEnd(maze_t const *maze, point_t *pos)
   *pos = maze->end;
 }
 
+bool_t SetMazeEndpoints(maze_t *maze, point_t const *start, point_t const *end)
+{
+  if (!maze) return false;
+  if (start && !GetMazeCell(maze, start)) return false;
+  if (end && !GetMazeCell(maze, end)) return false;
+  if (start) maze->start = *start;
+  if (end) maze->end = *end;
+  return true;
+}
+
+maze_conn_t const *GetMazeConnections(maze_t const *maze)
+{
+  if (!maze) return NULL;
+  return maze->conns;
+}
+
+maze_conn_t *GetMazeConnectionsMutable(maze_t *maze)
+{
+  if (!maze) return NULL;
+  return maze->conns;
+}
+
+uint64_t NextMazeRandom(maze_t *maze)
+{
+  if (maze && maze->seeded) return NextRng(&maze->rng);
+  return (uint64_t) rand();
+}
+
+void SplitMazeRng(maze_t *maze, rng_t *rng)
+{
+  if (!rng) return;
+  if (maze && maze->seeded) SplitRng(&maze->rng, rng);
+  else SeedRngFromRand(rng);
+}
+
 maze_cell_t *GetMazeCell(maze_t const *maze, point_t const *pos)
 {
   if (!maze || !pos) return NULL;
@@ -152,6 +263,172 @@ maze_cell_t *GetMazeEndCell(maze_t const *maze)
   return GetMazeCell(maze, &maze->end);
 }
 
+size_t ShiftMazeOrigin(
+  maze_t *maze, size_t steps, rng_t *rng,
+  point_t *changed, size_t max_changed, size_t *changed_count)
+{
+  point_t next, parent;
+  size_t height, width, origin_idx, next_idx, n, i;
+  maze_dir_t dir;
+  if (changed_count) *changed_count = 0;
+  if (!maze || !rng) return 0;
+  height = MazeHeight(maze);
+  width = MazeWidth(maze);
+  if (height * width < 2) return 0;
+  if (!maze->parents) BuildMazeParents(maze);
+  n = 0;
+  for (i = 0; i < steps; i++)
+  {
+    /* A step changes up to 3 cells. */
+    if (changed && max_changed - n < 3) break;
+    do
+    {
+      dir = (maze_dir_t) (NextRng(rng) & 0x3);
+      next = maze->origin;
+    }
+    while (!StepMazePoint(&next, dir, height, width));
+    origin_idx = maze->origin.row * width + maze->origin.col;
+    next_idx = next.row * width + next.col;
+    /* Old origin now points at the new origin. */
+    maze->conns[origin_idx] |= MazeDirToConn(dir);
+    maze->conns[next_idx] |= MazeDirToConn(OppositeMazeDir(dir));
+    maze->parents[origin_idx] = (uint8_t) dir;
+    if (changed) changed[n++] = maze->origin;
+    if (changed) changed[n++] = next;
+    /* New origin drops the connection to its old parent, unless that
+     * was the old origin. */
+    if (maze->parents[next_idx] < MAZE_DIR_COUNT
+        && maze->parents[next_idx] != OppositeMazeDir(dir))
+    {
+      parent = next;
+      StepMazePoint(&parent, (maze_dir_t) maze->parents[next_idx], height, width);
+      maze->conns[next_idx] &=
+        (maze_conn_t) ~MazeDirToConn(maze->parents[next_idx]);
+      maze->conns[parent.row * width + parent.col] &=
+        (maze_conn_t) ~MazeDirToConn(OppositeMazeDir(maze->parents[next_idx]));
+      if (changed) changed[n++] = parent;
+    }
+    maze->parents[next_idx] = MAZE_DIR_COUNT;
+    maze->origin = next;
+  }
+  if (changed_count) *changed_count = n;
+  return i;
+}
+
+void MazeOrigin(maze_t const *maze, point_t *pos)
+{
+  if (!maze || !pos) return;
+  *pos = maze->parents ? maze->origin : maze->start;
+}
+
+/* - - Maze Generator API - - */
+
+maze_gen_t *CreateMazeGenerator(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm, uint64_t const *seed)
+{
+  maze_gen_t *gen;
+  maze_t *maze;
+  maze = AllocateMaze(height, width, start, end, algorithm);
+  if (!maze) return NULL;
+  if (seed)
+  {
+    maze->seeded = true;
+    SeedRng(&maze->rng, *seed);
+  }
+  gen = (maze_gen_t*)calloc(1, sizeof(maze_gen_t));
+  gen->maze = maze;
+  switch (algorithm)
+  {
+    case MAZE_ALGO_CRAWL:
+      StartMazeCrawl(maze, &gen->crawl);
+      break;
+    case MAZE_ALGO_ELLER:
+      StartMazeEller(maze, &gen->eller);
+      break;
+    case MAZE_ALGO_WILSON:
+      gen->wilson = CreateWilsonGenerator(maze);
+      break;
+    case MAZE_ALGO_BACKTRACKER:
+      gen->backtrack = CreateBacktrackGenerator(maze);
+      break;
+    case MAZE_ALGO_HUNT_AND_KILL:
+      gen->hunt = CreateHuntGenerator(maze);
+      break;
+    default:
+      /* No resumable form. */
+      free(gen);
+      FreeMaze(maze);
+      return NULL;
+  }
+  return gen;
+}
+
+void FreeMazeGenerator(maze_gen_t *gen)
+{
+  if (!gen) return;
+  if (gen->crawl.queue) StopMazeCrawl(&gen->crawl);
+  if (gen->eller.gen) StopMazeEller(&gen->eller);
+  FreeWilsonGenerator(gen->wilson);
+  FreeBacktrackGenerator(gen->backtrack);
+  FreeHuntGenerator(gen->hunt);
+  memset(gen, 0, sizeof(maze_gen_t));
+  free(gen);
+}
+
+maze_t *GetGeneratorMaze(maze_gen_t const *gen)
+{
+  if (!gen) return NULL;
+  return gen->maze;
+}
+
+bool_t StepMazeGeneration(maze_gen_t *gen, size_t max_edges)
+{
+  if (!gen) return true;
+  if (gen->done) return true;
+  if (gen->crawl.queue)
+  {
+    gen->edges += StepMazeCrawl(gen->maze, &gen->crawl, max_edges);
+    gen->done = !gen->crawl.current;
+    if (gen->done) StopMazeCrawl(&gen->crawl);
+  }
+  else if (gen->eller.gen)
+  {
+    gen->edges += StepMazeEller(gen->maze, &gen->eller, max_edges);
+    gen->done = IsMazeEllerDone(gen->maze, &gen->eller);
+    if (gen->done) StopMazeEller(&gen->eller);
+  }
+  else if (gen->wilson)
+  {
+    /* Walk moves count against the edges, so a step is bounded. */
+    gen->edges += StepWilsonGenerator(gen->wilson, max_edges);
+    gen->done = IsWilsonGeneratorDone(gen->wilson);
+  }
+  else if (gen->backtrack)
+  {
+    gen->edges += StepBacktrackGenerator(gen->backtrack, max_edges);
+    gen->done = IsBacktrackGeneratorDone(gen->backtrack);
+  }
+  else if (gen->hunt)
+  {
+    gen->edges += StepHuntGenerator(gen->hunt, max_edges);
+    gen->done = IsHuntGeneratorDone(gen->hunt);
+  }
+  return gen->done;
+}
+
+bool_t IsMazeGenerationDone(maze_gen_t const *gen)
+{
+  if (!gen) return true;
+  return gen->done;
+}
+
+size_t MazeGenerationProgress(maze_gen_t const *gen)
+{
+  if (!gen) return 0;
+  return gen->edges;
+}
+
 size_t ComputeMazePath(
   maze_t const *maze, point_t const *src, point_t const *dest,
   point_t *path, size_t max_path)
@@ -192,16 +469,24 @@ size_t ComputeMazePath(
 
 /* - - Maze Internal API. - - */
 
-static void CrawlMazeDrawing(maze_t *maze, maze_cell_t *start)
+static void StartMazeCrawl(maze_t *maze, crawl_state_t *crawl)
+{
+  ClearMazeVisitedFlags(maze);
+  crawl->queue = CreatePriorityQueue();
+  crawl->current = GetMazeCell(maze, &maze->start);
+}
+
+static size_t StepMazeCrawl(maze_t *maze, crawl_state_t *crawl, size_t max_edges)
 {
   point_t poss[4];
-  size_t n, i;
+  size_t n, i, edges;
   maze_cell_t *current, *next;
   maze_cell_pair_t *conn;
   priority_queue_t *conn_queue;
-  conn_queue = CreatePriorityQueue();
-  current = start;
-  while (current)
+  conn_queue = crawl->queue;
+  current = crawl->current;
+  edges = 0;
+  while (current && edges < max_edges)
   {
     visit(current);
     /* Create a list of potential neighbours. */
@@ -217,7 +502,7 @@ static void CrawlMazeDrawing(maze_t *maze, maze_cell_t *start)
       next = GetMazeCell(maze, &poss[i]);
       if (!next || next->visited) continue;
       conn = CreateMazeCellPair(current, next);
-      EnqueuePriority(conn_queue, rand(), conn);
+      EnqueuePriority(conn_queue, NextMazeRandom(maze), conn);
     }
     /* Pop out a connection and make it */
     do
@@ -231,37 +516,196 @@ static void CrawlMazeDrawing(maze_t *maze, maze_cell_t *start)
       }
     }
     while (conn && next->visited);
-    if (!conn) break;
-    ConnectMazeCells(current, next);
+    if (!conn)
+    {
+      current = NULL;
+      break;
+    }
+    ConnectMazeCells(maze, current, next);
     current = next;
+    edges++;
+  }
+  crawl->current = current;
+  return edges;
+}
+
+static void StopMazeCrawl(crawl_state_t *crawl)
+{
+  ClearPriorityQueueDestroyItems(crawl->queue, FreeVoidMazeCellPair);
+  FreePriorityQueue(crawl->queue);
+  crawl->queue = NULL;
+  crawl->current = NULL;
+}
+
+static void StartMazeEller(maze_t *maze, eller_state_t *eller)
+{
+  rng_t rng;
+  eller->gen = CreateEllerGenerator(MazeWidth(maze));
+  /* Same stream as DrawEllerMaze(), so both draw the same Maze. */
+  SplitMazeRng(maze, &rng);
+  SeedEllerGenerator(eller->gen, NextRng(&rng));
+  eller->row = (maze_conn_t*)calloc(MazeWidth(maze), sizeof(maze_conn_t));
+  eller->rows = 0;
+  eller->next = 2 * MazeWidth(maze);
+}
+
+static size_t StepMazeEller(maze_t *maze, eller_state_t *eller, size_t max_edges)
+{
+  size_t height, width, col, idx, edges;
+  maze_dir_t dir;
+  height = MazeHeight(maze);
+  width = MazeWidth(maze);
+  edges = 0;
+  while (edges < max_edges)
+  {
+    if (eller->next == 2 * width)
+    {
+      if (eller->rows == height) break;
+      NextEllerRow(eller->gen, (eller->rows + 1) == height, eller->row);
+      eller->rows++;
+      eller->next = 0;
+    }
+    /* Each column draws its right, then its up connection. */
+    col = eller->next / 2;
+    dir = (eller->next % 2) ? MAZE_DIR_UP : MAZE_DIR_RIGHT;
+    eller->next++;
+    if (!(eller->row[col] & MazeDirToConn(dir))) continue;
+    idx = (eller->rows - 1) * width + col;
+    maze->conns[idx] |= MazeDirToConn(dir);
+    maze->conns[StepMazeIndex(idx, dir, width)] |= MazeDirToConn(OppositeMazeDir(dir));
+    edges++;
+  }
+  return edges;
+}
+
+static bool_t IsMazeEllerDone(maze_t const *maze, eller_state_t const *eller)
+{
+  return eller->rows == MazeHeight(maze) && eller->next == 2 * MazeWidth(maze);
+}
+
+static void StopMazeEller(eller_state_t *eller)
+{
+  FreeEllerGenerator(eller->gen);
+  free(eller->row);
+  memset(eller, 0, sizeof(eller_state_t));
+}
+
+static maze_t *AllocateMaze(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm)
+{
+  maze_t *maze;
+  point_t p;
+  if (!start || !end) return NULL;
+  if (height == 0 || width == 0) return NULL;
+  /* Enforce start end bounds. */
+  if (width <= start->col || width <= end->col) return NULL;
+  if (height <= start->row || height <= end->row) return NULL;
+  /* Create Maze struct. */
+  maze = (maze_t*)calloc(1, sizeof(maze_t));
+  /* Create Grid for storing Maze Cells. */
+  maze->grid = CreateGrid(height, width);
+  maze->conns = (maze_conn_t*)calloc(height * width, sizeof(maze_conn_t));
+  maze->start = *start;
+  maze->end = *end;
+  maze->algorithm = algorithm;
+  /* Creates a new Maze Cell for every point.  */
+  for (p.row = 0; p.row < height; p.row++)
+  {
+    for (p.col = 0; p.col < width; p.col++)
+    {
+      SetGridCell(maze->grid, &p, CreateMazeCell(maze, &p));
+    }
   }
-  FreePriorityQueue(conn_queue);
+  return maze;
 }
 
 static void DrawMaze(maze_t *maze)
 {
-  ClearMazeVisitedFlags(maze);
-  CrawlMazeDrawing(maze, GetMazeCell(maze, &maze->start));
+  if (maze->tiles > 1)
+  {
+    DrawTiledMaze(maze, maze->algorithm, maze->tiles);
+    return;
+  }
+  switch (maze->algorithm)
+  {
+    case MAZE_ALGO_ELLER:
+      DrawEllerMaze(maze);
+      break;
+    case MAZE_ALGO_WILSON:
+      DrawWilsonMaze(maze);
+      break;
+    case MAZE_ALGO_DIVISION:
+      DrawDivisionMaze(maze);
+      break;
+    case MAZE_ALGO_BINARY_TREE:
+      DrawBinaryTreeMaze(maze);
+      break;
+    case MAZE_ALGO_SIDEWINDER:
+      DrawSidewinderMaze(maze);
+      break;
+    case MAZE_ALGO_BACKTRACKER:
+      DrawBacktrackerMaze(maze);
+      break;
+    case MAZE_ALGO_HUNT_AND_KILL:
+      DrawHuntAndKillMaze(maze);
+      break;
+    case MAZE_ALGO_CRAWL:
+    default:
+    {
+      crawl_state_t crawl;
+      StartMazeCrawl(maze, &crawl);
+      StepMazeCrawl(maze, &crawl, SIZE_MAX);
+      StopMazeCrawl(&crawl);
+      break;
+    }
+  }
 }
 
 static void ClearMazeConnections(maze_t *maze)
 {
-  point_t pos;
-  size_t height, width;
-  maze_cell_t *cell;
   if (!maze) return;
+  memset(maze->conns, 0,
+    MazeHeight(maze) * MazeWidth(maze) * sizeof(maze_conn_t));
+}
+
+static void BuildMazeParents(maze_t *maze)
+{
+  point_t pos, next;
+  size_t height, width, idx, d;
+  uint8_t const kNoParent = 0xFF;
   height = MazeHeight(maze);
   width = MazeWidth(maze);
-  for (pos.row = 0; pos.row < height; pos.row++)
+  maze->parents = (uint8_t*)malloc(height * width * sizeof(uint8_t));
+  memset(maze->parents, kNoParent, height * width * sizeof(uint8_t));
+  maze->origin = maze->start;
+  /* Depth-first walk that backtracks through the parent directions, so
+   * no stack is needed.  `d` is the next direction to try. */
+  pos = maze->origin;
+  maze->parents[pos.row * width + pos.col] = MAZE_DIR_COUNT;
+  d = 0;
+  while (true)
   {
-    for (pos.col = 0; pos.col < width; pos.col++)
+    idx = pos.row * width + pos.col;
+    for (; d < MAZE_DIR_COUNT; d++)
     {
-      cell = GetGridCell(maze->grid, &pos);
-      cell->up = NULL;
-      cell->down = NULL;
-      cell->left = NULL;
-      cell->right = NULL;
+      if (!(maze->conns[idx] & MazeDirToConn(d))) continue;
+      next = pos;
+      StepMazePoint(&next, (maze_dir_t) d, height, width);
+      if (maze->parents[next.row * width + next.col] != kNoParent) continue;
+      maze->parents[next.row * width + next.col] =
+        (uint8_t) OppositeMazeDir((maze_dir_t) d);
+      break;
+    }
+    if (d < MAZE_DIR_COUNT)
+    {
+      pos = next;
+      d = 0;
+      continue;
     }
+    if (PointsEqual(&pos, &maze->origin)) break;
+    d = OppositeMazeDir((maze_dir_t) maze->parents[idx]) + 1;
+    StepMazePoint(&pos, (maze_dir_t) maze->parents[idx], height, width);
   }
 }
 
@@ -327,25 +771,50 @@ void DecMazeCellProperty(maze_cell_t *cell, maze_property_t property)
   cell->properties[property]--;
 }
 
+maze_conn_t GetMazeCellConnections(maze_cell_t const *cell)
+{
+  if (!cell) return 0;
+  return cell->maze->conns[cell->pos.row * MazeWidth(cell->maze) + cell->pos.col];
+}
+
 size_t GetMazeCellNeighbourPoints(maze_cell_t const *cell, point_t *neighbours)
 {
   size_t i;
+  maze_conn_t conn;
   if (!cell || !neighbours) return 0;
+  conn = GetMazeCellConnections(cell);
   i = 0;
-  if (cell->up) neighbours[i++] = cell->up->pos;
-  if (cell->down) neighbours[i++] = cell->down->pos;
-  if (cell->left) neighbours[i++] = cell->left->pos;
-  if (cell->right) neighbours[i++] = cell->right->pos;
+  if (conn & MAZE_CONN_UP)
+  {
+    neighbours[i] = cell->pos;
+    neighbours[i++].row++;
+  }
+  if (conn & MAZE_CONN_DOWN)
+  {
+    neighbours[i] = cell->pos;
+    neighbours[i++].row--;
+  }
+  if (conn & MAZE_CONN_LEFT)
+  {
+    neighbours[i] = cell->pos;
+    neighbours[i++].col--;
+  }
+  if (conn & MAZE_CONN_RIGHT)
+  {
+    neighbours[i] = cell->pos;
+    neighbours[i++].col++;
+  }
   return i;
 }
 
 /* - - Maze Cell Internal API. - - */
 
-static maze_cell_t *CreateMazeCell(point_t const *pos)
+static maze_cell_t *CreateMazeCell(maze_t const *maze, point_t const *pos)
 {
   maze_cell_t *cell;
-  if (!pos) return NULL;
+  if (!maze || !pos) return NULL;
   cell = (maze_cell_t*)calloc(1, sizeof(maze_cell_t));
+  cell->maze = maze;
   cell->pos = *pos;
   return cell;
 }
@@ -357,34 +826,38 @@ static void FreeMazeCell(maze_cell_t *cell)
   free(cell);
 }
 
-static void ConnectMazeCells(maze_cell_t *a, maze_cell_t *b)
+static void ConnectMazeCells(maze_t *maze, maze_cell_t *a, maze_cell_t *b)
 {
-  if (!a || !b) return;
+  size_t width, aidx, bidx;
+  if (!maze || !a || !b) return;
   if (PointsEqual(&a->pos, &b->pos)) return;
+  width = MazeWidth(maze);
+  aidx = a->pos.row * width + a->pos.col;
+  bidx = b->pos.row * width + b->pos.col;
   if (a->pos.col == b->pos.col)
   {
     if ((a->pos.row + 1) == b->pos.row)
     {
-      a->up = b;
-      b->down = a;
+      maze->conns[aidx] |= MAZE_CONN_UP;
+      maze->conns[bidx] |= MAZE_CONN_DOWN;
     }
     else if (a->pos.row == (b->pos.row + 1))
     {
-      a->down = b;
-      b->up = a;
+      maze->conns[aidx] |= MAZE_CONN_DOWN;
+      maze->conns[bidx] |= MAZE_CONN_UP;
     }
   }
   else if (a->pos.row == b->pos.row)
   {
     if ((a->pos.col + 1) == b->pos.col)
     {
-      a->right = b;
-      b->left = a;
+      maze->conns[aidx] |= MAZE_CONN_RIGHT;
+      maze->conns[bidx] |= MAZE_CONN_LEFT;
     }
     else if (a->pos.col == (b->pos.col + 1))
     {
-      a->left = b;
-      b->right = a;
+      maze->conns[aidx] |= MAZE_CONN_LEFT;
+      maze->conns[bidx] |= MAZE_CONN_RIGHT;
     }
   }
   return;
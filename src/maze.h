@@ -10,6 +10,7 @@
 #define _MAZE_H_
 
 #include "common.h"
+#include "rng.h"
 
 /* - - Maze and Maze Cell Handles - - */
 
@@ -30,6 +31,110 @@ typedef struct maze_st maze_t;
  */
 typedef struct maze_cell_st maze_cell_t;
 
+/* - - Maze Directions and Connections - - */
+
+/*
+ * Maze Direction
+ *  Direction from a Maze Cell to one of its adjacent Maze Cells.  Names
+ *  match the Maze Cell neighbours: "up" is the next row (row + 1) and
+ *  "right" is the next column (col + 1).  Opposite directions only
+ *  differ by the lowest bit, so a direction always fits in 2 bits.
+ */
+typedef enum {
+  MAZE_DIR_UP = 0,
+  MAZE_DIR_DOWN = 1,
+  MAZE_DIR_LEFT = 2,
+  MAZE_DIR_RIGHT = 3
+} maze_dir_t;
+
+#define MAZE_DIR_COUNT 4
+
+/*
+ * Maze Connections
+ *  Bit-mask of the directions in which a Maze Cell is connected to its
+ *  neighbours.  One bit per Maze Direction.
+ */
+typedef uint8_t maze_conn_t;
+
+#define MazeDirToConn(dir) ((maze_conn_t) (1 << (dir)))
+#define MAZE_CONN_UP MazeDirToConn(MAZE_DIR_UP)
+#define MAZE_CONN_DOWN MazeDirToConn(MAZE_DIR_DOWN)
+#define MAZE_CONN_LEFT MazeDirToConn(MAZE_DIR_LEFT)
+#define MAZE_CONN_RIGHT MazeDirToConn(MAZE_DIR_RIGHT)
+
+static inline maze_dir_t OppositeMazeDir(maze_dir_t dir)
+{
+  return (maze_dir_t) (dir ^ 1);
+}
+
+/* Moves `pos` one cell in direction `dir`.  Returns false and leaves
+ * `pos` unchanged if the move would leave a `height` x `width` Maze. */
+static inline bool_t StepMazePoint(
+  point_t *pos, maze_dir_t dir, size_t height, size_t width)
+{
+  switch (dir)
+  {
+    case MAZE_DIR_UP:
+      if (pos->row + 1 >= height) return false;
+      pos->row++;
+      return true;
+    case MAZE_DIR_DOWN:
+      if (pos->row == 0) return false;
+      pos->row--;
+      return true;
+    case MAZE_DIR_LEFT:
+      if (pos->col == 0) return false;
+      pos->col--;
+      return true;
+    case MAZE_DIR_RIGHT:
+      if (pos->col + 1 >= width) return false;
+      pos->col++;
+      return true;
+    default:
+      return false;
+  }
+}
+
+/* Index of the neighbour of cell `idx` in direction `dir`, for Mazes
+ * stored row-major with `width` columns.  The neighbour must exist,
+ * which is always the case for a direction in a cell's connections. */
+static inline size_t StepMazeIndex(size_t idx, maze_dir_t dir, size_t width)
+{
+  switch (dir)
+  {
+    case MAZE_DIR_UP:
+      return idx + width;
+    case MAZE_DIR_DOWN:
+      return idx - width;
+    case MAZE_DIR_LEFT:
+      return idx - 1;
+    case MAZE_DIR_RIGHT:
+    default:
+      return idx + 1;
+  }
+}
+
+/* - - Maze Generating Algorithms - - */
+
+typedef enum {
+  /* Randomized crawl from the start cell (default). */
+  MAZE_ALGO_CRAWL,
+  /* Eller's algorithm, generated one row at a time. */
+  MAZE_ALGO_ELLER,
+  /* Wilson's algorithm, uniform spanning tree. */
+  MAZE_ALGO_WILSON,
+  /* Task-parallel recursive division. */
+  MAZE_ALGO_DIVISION,
+  /* Bit-parallel binary tree, biased towards up and right. */
+  MAZE_ALGO_BINARY_TREE,
+  /* Bit-parallel sidewinder, biased towards long rows. */
+  MAZE_ALGO_SIDEWINDER,
+  /* Depth-first recursive backtracker, long corridors. */
+  MAZE_ALGO_BACKTRACKER,
+  /* Hunt-and-kill, constant extra memory. */
+  MAZE_ALGO_HUNT_AND_KILL
+} maze_algorithm_t;
+
 /* - - Maze API - - */
 /* Maze constructor.  Generates a Maze using the given dimensions,
  * starting at the provided starting point.  The end point is stored,
@@ -44,6 +149,26 @@ typedef struct maze_cell_st maze_cell_t;
  * accessed by reference using the appropriate GetMazeCell() call.
  */
 maze_t *CreateMaze(size_t height, size_t width, point_t const *start, point_t const *end);
+/* Same as CreateMaze(), but the Maze is drawn using the given
+ * algorithm.  The algorithm is also used by later calls to
+ * ReDrawMaze(). */
+maze_t *CreateMazeWithAlgorithm(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm);
+/* Same as CreateMazeWithAlgorithm(), but the Maze draws from its own
+ * random stream seeded with `seed`, rather than from rand().  The same
+ * seed always gives the same Maze, and seeded Mazes can be drawn on
+ * different threads at the same time. */
+maze_t *CreateSeededMaze(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm, uint64_t seed);
+/* Same as CreateMazeWithAlgorithm(), but the Maze is split into
+ * `tiles` x `tiles` tiles which are drawn in parallel and then joined.
+ * See maze_tiled.h for details.  A tile count of 0 or 1 draws the Maze
+ * as a whole. */
+maze_t *CreateTiledMaze(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm, size_t tiles);
 /* Maze destructor.  This will free all Maze Cells and other internal
  * Maze resources.  All external references to Maze Cells should
  * treated as dead pointers. */
@@ -61,12 +186,88 @@ size_t MazeWidth(maze_t const *maze);
 /* Maze start and end position getters. */
 void MazeStart(maze_t const *maze, point_t *pos);
 void MazeEnd(maze_t const *maze, point_t *pos);
+/* Moves the start and end without redrawing the Maze, a NULL point is
+ * left as is.  Returns false, and changes nothing, if a point is
+ * outside the Maze. */
+bool_t SetMazeEndpoints(maze_t *maze, point_t const *start, point_t const *end);
+
+/* Raw Maze connection storage.  Row-major array of MazeHeight() x
+ * MazeWidth() Maze Connection masks (index is row * width + col).
+ * Generators may write straight into the mutable array, but they are
+ * responsible for keeping connections symmetric between neighbours. */
+maze_conn_t const *GetMazeConnections(maze_t const *maze);
+maze_conn_t *GetMazeConnectionsMutable(maze_t *maze);
+
+/* Random values used for drawing the Maze.  Uses the Maze's own
+ * stream if it was created with CreateSeededMaze(), rand() otherwise. */
+uint64_t NextMazeRandom(maze_t *maze);
+/* Seeds `rng` with a new stream drawn from the Maze's random source,
+ * for generators that need independent streams. */
+void SplitMazeRng(maze_t *maze, rng_t *rng);
 
 /* Maze Cell getters. */
 maze_cell_t *GetMazeCell(maze_t const *maze, point_t const *pos);
 maze_cell_t *GetMazeStartCell(maze_t const *maze);
 maze_cell_t *GetMazeEndCell(maze_t const *maze);
 
+/* - - Origin Shift - - */
+
+/* Mutates the Maze in place with the origin-shift algorithm.  The Maze
+ * is kept as a tree rooted at an origin cell (initially the Maze
+ * start), with each cell storing the direction to its parent.  Each
+ * step moves the origin to a random neighbour, which adds at most one
+ * connection and removes at most one, so the Maze stays perfect.
+ *
+ * Unless `changed` is NULL, the cells whose connections changed are
+ * written to it, up to 3 per step, and `changed_count` (if not NULL)
+ * is set to the number written.  A cell may be reported more than
+ * once.  Shifting stops early, before a step that might not fit in
+ * the `max_changed` points, so no change goes unreported.  Returns the
+ * number of steps done.  Parent directions are built on the first
+ * call, and dropped by ReDrawMaze(). */
+size_t ShiftMazeOrigin(
+  maze_t *maze, size_t steps, rng_t *rng,
+  point_t *changed, size_t max_changed, size_t *changed_count);
+/* Current origin of the Maze, the Maze start if never shifted. */
+void MazeOrigin(maze_t const *maze, point_t *pos);
+
+/* - - Step-wise Generation - - */
+
+/*
+ * Maze Generator
+ *  Draws a new Maze a bounded number of connections at a time, so that
+ *  generation can be interleaved with other work, resumed later, or
+ *  cancelled by freeing the generator.  A finished Maze has
+ *  height * width - 1 connections.  The crawl, Eller, Wilson,
+ *  backtracker and hunt-and-kill algorithms are drawn step-wise; there
+ *  is no generator for the others.  The Maze should not be traversed
+ *  until generation is done.
+ */
+typedef struct maze_gen_st maze_gen_t;
+
+/* Maze Generator constructor.  Allocates an undrawn Maze with the same
+ * parameters as CreateMazeWithAlgorithm().  If `seed` is not NULL, the
+ * Maze draws from its own stream as in CreateSeededMaze().  Returns
+ * NULL if the Maze parameters are invalid, or if the algorithm cannot
+ * be drawn step-wise. */
+maze_gen_t *CreateMazeGenerator(
+  size_t height, size_t width, point_t const *start, point_t const *end,
+  maze_algorithm_t algorithm, uint64_t const *seed);
+/* Maze Generator destructor.  The Maze is not freed, and is left as
+ * drawn so far if generation was not done. */
+void FreeMazeGenerator(maze_gen_t *gen);
+/* The Maze being drawn.  The caller owns it, and must release it with
+ * FreeMaze() after the generator is freed. */
+maze_t *GetGeneratorMaze(maze_gen_t const *gen);
+
+/* Draws at most `max_edges` connections.  The moves of Wilson's random
+ * walks count against `max_edges` too, so a step may draw fewer while
+ * a walk wanders.  Returns true once the Maze is done. */
+bool_t StepMazeGeneration(maze_gen_t *gen, size_t max_edges);
+bool_t IsMazeGenerationDone(maze_gen_t const *gen);
+/* Number of connections drawn so far. */
+size_t MazeGenerationProgress(maze_gen_t const *gen);
+
 /* Gets path from src to dest.  Returns 0 if no path exists. If src and
  * dest are the same point, then 1 path element is returned.  All
  * paramenters must be non-NULL. */
@@ -104,6 +305,9 @@ void SetMazeCellProperty(
 void IncMazeCellProperty(maze_cell_t *cell, maze_property_t property);
 void DecMazeCellProperty(maze_cell_t *cell, maze_property_t property);
 
+/* Connection mask of the Maze Cell. */
+maze_conn_t GetMazeCellConnections(maze_cell_t const *cell);
+
 /* Neighbours buffer must be large enough to fit 4 points */
 size_t GetMazeCellNeighbourPoints(maze_cell_t const *cell, point_t *neightbours);
 
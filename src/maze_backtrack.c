@@ -0,0 +1,148 @@
+/*
+ * Mazart - Recursive Backtracker Maze Generator
+ *  Module provides a depth-first backtracking Maze generator, which
+ *  gives Mazes with long corridors.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_backtrack.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define DIRS_PER_WORD 32
+
+/* Initial stack capacity in words, grows by doubling. */
+static size_t const kBacktrackStackWords = 64;
+
+/* - - Direction Stack - - */
+
+/* Stack of 2-bit Maze Directions. */
+typedef struct {
+  uint64_t *words;
+  size_t capacity;   /* In words. */
+  size_t size;       /* In directions. */
+} dir_stack_t;
+
+static void PushDirStack(dir_stack_t *stack, maze_dir_t dir)
+{
+  size_t word, shift;
+  word = stack->size / DIRS_PER_WORD;
+  shift = (stack->size % DIRS_PER_WORD) * 2;
+  if (word == stack->capacity)
+  {
+    stack->capacity *= 2;
+    stack->words = (uint64_t*)realloc(
+      stack->words, stack->capacity * sizeof(uint64_t));
+  }
+  if (shift == 0) stack->words[word] = 0;
+  stack->words[word] |= ((uint64_t) dir) << shift;
+  stack->size++;
+}
+
+static maze_dir_t PopDirStack(dir_stack_t *stack)
+{
+  size_t word, shift;
+  uint64_t dir;
+  stack->size--;
+  word = stack->size / DIRS_PER_WORD;
+  shift = (stack->size % DIRS_PER_WORD) * 2;
+  dir = (stack->words[word] >> shift) & 0x3;
+  stack->words[word] &= ~(((uint64_t) 0x3) << shift);
+  return (maze_dir_t) dir;
+}
+
+/* - - Backtracker Generator Structure - - */
+
+struct backtrack_gen_st {
+  maze_t *maze;
+  maze_conn_t *conns;
+  size_t height;
+  size_t width;
+  point_t start;
+  point_t pos;        /* Head of the search. */
+  dir_stack_t stack;
+  bool_t done;
+};
+
+/* - - Backtracker API - - */
+
+backtrack_gen_t *CreateBacktrackGenerator(maze_t *maze)
+{
+  backtrack_gen_t *gen;
+  if (!maze) return NULL;
+  gen = (backtrack_gen_t*)calloc(1, sizeof(backtrack_gen_t));
+  gen->maze = maze;
+  gen->conns = GetMazeConnectionsMutable(maze);
+  gen->height = MazeHeight(maze);
+  gen->width = MazeWidth(maze);
+  gen->stack.capacity = kBacktrackStackWords;
+  gen->stack.size = 0;
+  gen->stack.words = (uint64_t*)calloc(gen->stack.capacity, sizeof(uint64_t));
+  MazeStart(maze, &gen->start);
+  gen->pos = gen->start;
+  gen->done = gen->height * gen->width < 2;
+  return gen;
+}
+
+void FreeBacktrackGenerator(backtrack_gen_t *gen)
+{
+  if (!gen) return;
+  free(gen->stack.words);
+  memset(gen, 0, sizeof(backtrack_gen_t));
+  free(gen);
+}
+
+size_t StepBacktrackGenerator(backtrack_gen_t *gen, size_t max_edges)
+{
+  maze_dir_t dirs[MAZE_DIR_COUNT], dir;
+  point_t next;
+  size_t idx, edges, n, d;
+  if (!gen) return 0;
+  edges = 0;
+  while (!gen->done && edges < max_edges)
+  {
+    /* Unvisited neighbours, the start is the only visited cell
+     * without connections. */
+    n = 0;
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      next = gen->pos;
+      if (!StepMazePoint(&next, (maze_dir_t) d, gen->height, gen->width)) continue;
+      if (gen->conns[next.row * gen->width + next.col]) continue;
+      if (PointsEqual(&next, &gen->start)) continue;
+      dirs[n++] = (maze_dir_t) d;
+    }
+    if (n == 0)
+    {
+      if (gen->stack.size == 0) gen->done = true;
+      else StepMazePoint(&gen->pos, PopDirStack(&gen->stack), gen->height, gen->width);
+      continue;
+    }
+    dir = dirs[NextMazeRandom(gen->maze) % n];
+    idx = gen->pos.row * gen->width + gen->pos.col;
+    StepMazePoint(&gen->pos, dir, gen->height, gen->width);
+    gen->conns[idx] |= MazeDirToConn(dir);
+    gen->conns[gen->pos.row * gen->width + gen->pos.col] |=
+      MazeDirToConn(OppositeMazeDir(dir));
+    PushDirStack(&gen->stack, OppositeMazeDir(dir));
+    edges++;
+  }
+  return edges;
+}
+
+bool_t IsBacktrackGeneratorDone(backtrack_gen_t const *gen)
+{
+  if (!gen) return true;
+  return gen->done;
+}
+
+void DrawBacktrackerMaze(maze_t *maze)
+{
+  backtrack_gen_t *gen;
+  gen = CreateBacktrackGenerator(maze);
+  StepBacktrackGenerator(gen, SIZE_MAX);
+  FreeBacktrackGenerator(gen);
+}
@@ -0,0 +1,38 @@
+/*
+ * Mazart - Recursive Backtracker Maze Generator
+ *  Module provides a depth-first backtracking Maze generator, which
+ *  gives Mazes with long corridors.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_BACKTRACK_H_
+#define _MAZE_BACKTRACK_H_
+
+#include "common.h"
+#include "maze.h"
+
+/* Draws the Maze's connections with a depth-first search from the Maze
+ * start.  There is no recursion, the explicit stack only stores the
+ * 2-bit direction back to each parent cell, packed 32 to a word.  A
+ * cell counts as visited once it has a connection, so no visited flags
+ * are needed.  The Maze connections are expected to be cleared. */
+void DrawBacktrackerMaze(maze_t *maze);
+
+/*
+ * Backtracker Generator
+ *  Resumable form of DrawBacktrackerMaze(), the search state is kept
+ *  between steps.  The Maze must outlive the generator, and its
+ *  connections are expected to be cleared before the first step.
+ */
+typedef struct backtrack_gen_st backtrack_gen_t;
+
+backtrack_gen_t *CreateBacktrackGenerator(maze_t *maze);
+/* Frees the generator, the Maze is left as drawn so far. */
+void FreeBacktrackGenerator(backtrack_gen_t *gen);
+/* Draws at most `max_edges` connections.  Returns the number drawn. */
+size_t StepBacktrackGenerator(backtrack_gen_t *gen, size_t max_edges);
+bool_t IsBacktrackGeneratorDone(backtrack_gen_t const *gen);
+
+#endif /* _MAZE_BACKTRACK_H_ */
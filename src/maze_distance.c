@@ -0,0 +1,601 @@
+/*
+ * Mazart - Maze Distance Fields
+ *  Module fills cell properties with the number of steps from the
+ *  solution path, the Maze start and the Maze end.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_distance.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "maze_flood.h"
+#include "thread_pool.h"
+
+/* Distance of a cell that has not been reached. */
+#define DIST_UNSEEN UINT32_MAX
+
+/* Mazes with fewer cells than this are processed on the calling
+ * thread. */
+static size_t const kDistParallelCells = 65536;
+/* Branch tasks kept queued or running per worker thread, so a worker
+ * that finishes its branch finds another one waiting. */
+static size_t const kDistBranchesPerThread = 2;
+/* Cells a branch spreads between checks for a branch to hand out. */
+static size_t const kDistSplitPeriod = 1024;
+
+/* Internal field of FillMazeSourceRegions(), one more than the index
+ * of the cell's source, from its anchor. */
+#define DIST_FIELD_OWNER MAZE_DIST_FIELD_COUNT
+#define DIST_FIELD_COUNT (MAZE_DIST_FIELD_COUNT + 1)
+
+/* Packed distance and anchor of a cell that has not been reached. */
+#define DIST_KEY_UNSEEN UINT64_MAX
+/* Adds one step to a packed distance and anchor. */
+#define DIST_KEY_STEP (((uint64_t) 1) << 32)
+
+/* - - Maze Distance Structures - - */
+
+typedef struct dist_job_st dist_job_t;
+
+/* Queued cells of one branch task.  The subtrees hanging off them are
+ * reached from nowhere else in a Maze without loops. */
+typedef struct {
+  dist_job_t *job;
+  size_t *cells;      /* Queued from head to tail. */
+  size_t head;
+  size_t tail;
+  size_t capacity;
+} dist_branch_t;
+
+/* One breadth-first pass over the Maze connections. */
+struct dist_job_st {
+  maze_conn_t const *conns;
+  size_t height;
+  size_t width;
+  size_t count;
+  uint32_t *dist;     /* Steps from the nearest seed. */
+  uint32_t *anchor;   /* Path step of that seed, NULL for one source. */
+  size_t *queue;
+  size_t tail;        /* Cells queued, the cells reached once spread. */
+  thread_pool_t *pool;
+  /* Spread by branch tasks, for Mazes without loops. */
+  bool_t branching;
+  uint64_t *keys;     /* Distance and anchor packed, while branching. */
+  size_t branches;    /* Branch tasks queued or running. */
+  size_t max_branches;
+  size_t reached;     /* Cells claimed by branch tasks. */
+  size_t degrees;
+};
+
+/* - - Maze Distance Internal API - - */
+
+static inline size_t CountConns(maze_conn_t conns)
+{
+  return (size_t) __builtin_popcount(conns);
+}
+
+static inline bool_t InsideJob(dist_job_t const *job, point_t const *pos)
+{
+  return pos->row < job->height && pos->col < job->width;
+}
+
+static void ResetDistJob(dist_job_t *job)
+{
+  memset(job->dist, 0xFF, job->count * sizeof(uint32_t));
+  if (job->anchor) memset(job->anchor, 0xFF, job->count * sizeof(uint32_t));
+  job->tail = 0;
+}
+
+/* Seeds the cell at `pos`, anchored at `step`.  A cell seeded twice
+ * keeps the smaller step. */
+static void SeedDistJob(dist_job_t *job, point_t const *pos, uint32_t step)
+{
+  size_t idx;
+  idx = pos->row * job->width + pos->col;
+  if (job->anchor && job->anchor[idx] > step) job->anchor[idx] = step;
+  if (job->dist[idx] != DIST_UNSEEN) return;
+  job->dist[idx] = 0;
+  job->queue[job->tail++] = idx;
+}
+
+/* Seeds every cell of `path`.  Returns false if it leaves the Maze. */
+static bool_t SeedDistJobPath(dist_job_t *job, maze_path_t const *path)
+{
+  maze_path_iter_t iter;
+  StartMazePathIter(&iter, path);
+  while (NextMazePathIter(&iter))
+  {
+    if (!InsideJob(job, &iter.pos)) return false;
+    SeedDistJob(job, &iter.pos, (uint32_t) (iter.index - 1));
+  }
+  return true;
+}
+
+/* Spreads the queued cells from `first` to `end` on the calling
+ * thread, queueing the next level.  A cell reached from several cells
+ * of the level takes the smallest of their anchors, so the anchor is
+ * the smallest among its nearest seeds.  Returns the connection count
+ * of the cells spread. */
+static size_t SpreadDistLevel(dist_job_t *job, size_t first, size_t end)
+{
+  maze_conn_t conns;
+  size_t i, u, v, d, degrees;
+  degrees = 0;
+  for (i = first; i < end; i++)
+  {
+    u = job->queue[i];
+    conns = job->conns[u];
+    degrees += CountConns(conns);
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      if (!(conns & MazeDirToConn(d))) continue;
+      v = StepMazeIndex(u, (maze_dir_t) d, job->width);
+      if (job->dist[v] == DIST_UNSEEN)
+      {
+        job->dist[v] = job->dist[u] + 1;
+        job->queue[job->tail++] = v;
+      }
+      if (job->anchor && job->dist[v] == job->dist[u] + 1
+          && job->anchor[u] < job->anchor[v])
+      {
+        job->anchor[v] = job->anchor[u];
+      }
+    }
+  }
+  return degrees;
+}
+
+static dist_branch_t *CreateDistBranch(
+  dist_job_t *job, size_t const *cells, size_t count)
+{
+  dist_branch_t *branch;
+  branch = (dist_branch_t*)malloc(sizeof(dist_branch_t));
+  branch->job = job;
+  branch->capacity = count < kDistSplitPeriod ? kDistSplitPeriod : 2 * count;
+  branch->cells = (size_t*)malloc(branch->capacity * sizeof(size_t));
+  memcpy(branch->cells, cells, count * sizeof(size_t));
+  branch->head = 0;
+  branch->tail = count;
+  return branch;
+}
+
+static void FreeDistBranch(dist_branch_t *branch)
+{
+  free(branch->cells);
+  free(branch);
+}
+
+static void PushDistBranch(dist_branch_t *branch, size_t cell)
+{
+  if (branch->tail == branch->capacity)
+  {
+    if (branch->head >= branch->capacity / 2)
+    {
+      memmove(branch->cells, &branch->cells[branch->head],
+        (branch->tail - branch->head) * sizeof(size_t));
+      branch->tail -= branch->head;
+      branch->head = 0;
+    }
+    else
+    {
+      branch->capacity *= 2;
+      branch->cells = (size_t*)realloc(branch->cells, branch->capacity * sizeof(size_t));
+    }
+  }
+  branch->cells[branch->tail++] = cell;
+}
+
+static void SpreadDistBranch(void *arg);
+
+/* Hands the later half of the branch's queued cells to a new branch
+ * task. */
+static void SplitDistBranch(dist_branch_t *branch)
+{
+  dist_job_t *job;
+  dist_branch_t *other;
+  size_t mid;
+  job = branch->job;
+  if (branch->tail - branch->head < 2) return;
+  mid = branch->head + (branch->tail - branch->head) / 2;
+  other = CreateDistBranch(job, &branch->cells[mid], branch->tail - mid);
+  __atomic_add_fetch(&job->branches, 1, __ATOMIC_RELAXED);
+  if (!SubmitThreadTask(job->pool, SpreadDistBranch, other))
+  {
+    __atomic_sub_fetch(&job->branches, 1, __ATOMIC_RELAXED);
+    FreeDistBranch(other);
+    return;
+  }
+  branch->tail = mid;
+}
+
+/* Thread Pool task.  Spreads the branch's queued cells breadth-first,
+ * claiming a cell by lowering its packed distance and anchor.  The
+ * smallest key is the serial pass's distance and smallest anchor, so a
+ * cell first reached by a longer way, which only happens with loops,
+ * is lowered and spread again. */
+static void SpreadDistBranch(void *arg)
+{
+  dist_branch_t *branch;
+  dist_job_t *job;
+  maze_conn_t conns;
+  uint64_t next, current;
+  size_t u, v, d, reached, degrees, since;
+  branch = (dist_branch_t*)arg;
+  job = branch->job;
+  reached = degrees = since = 0;
+  while (branch->head < branch->tail)
+  {
+    if (++since == kDistSplitPeriod)
+    {
+      since = 0;
+      if (__atomic_load_n(&job->branches, __ATOMIC_RELAXED) < job->max_branches)
+        SplitDistBranch(branch);
+    }
+    u = branch->cells[branch->head++];
+    conns = job->conns[u];
+    next = __atomic_load_n(&job->keys[u], __ATOMIC_RELAXED) + DIST_KEY_STEP;
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      if (!(conns & MazeDirToConn(d))) continue;
+      v = StepMazeIndex(u, (maze_dir_t) d, job->width);
+      current = __atomic_load_n(&job->keys[v], __ATOMIC_RELAXED);
+      while (next < current)
+      {
+        if (!__atomic_compare_exchange_n(&job->keys[v], &current, next,
+            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) continue;
+        if (current == DIST_KEY_UNSEEN)
+        {
+          reached++;
+          degrees += CountConns(job->conns[v]);
+        }
+        PushDistBranch(branch, v);
+        break;
+      }
+    }
+  }
+  __atomic_add_fetch(&job->reached, reached, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&job->degrees, degrees, __ATOMIC_RELAXED);
+  FreeDistBranch(branch);
+  __atomic_sub_fetch(&job->branches, 1, __ATOMIC_RELAXED);
+}
+
+/* Spreads the queued seeds as branch tasks on the Thread Pool, which
+ * split further while workers are idle.  Returns the connection count
+ * of the cells reached, as SpreadDistJob(). */
+static size_t SpreadDistBranches(dist_job_t *job)
+{
+  dist_branch_t *branch;
+  size_t i, u, count, size;
+  job->keys = (uint64_t*)malloc(job->count * sizeof(uint64_t));
+  memset(job->keys, 0xFF, job->count * sizeof(uint64_t));
+  job->reached = job->tail;
+  job->degrees = 0;
+  for (i = 0; i < job->tail; i++)
+  {
+    u = job->queue[i];
+    job->keys[u] = job->anchor ? job->anchor[u] : 0;
+    job->degrees += CountConns(job->conns[u]);
+  }
+  /* Seeds, such as the path cells, are handed out in runs. */
+  count = job->tail < job->max_branches ? job->tail : job->max_branches;
+  size = (job->tail + count - 1) / count;
+  for (i = 0; i < job->tail; i += size)
+  {
+    branch = CreateDistBranch(job, &job->queue[i],
+      job->tail - i < size ? job->tail - i : size);
+    __atomic_add_fetch(&job->branches, 1, __ATOMIC_RELAXED);
+    if (!SubmitThreadTask(job->pool, SpreadDistBranch, branch)) SpreadDistBranch(branch);
+  }
+  WaitThreadPool(job->pool);
+  for (u = 0; u < job->count; u++)
+  {
+    job->dist[u] = (uint32_t) (job->keys[u] >> 32);
+    if (job->anchor) job->anchor[u] = (uint32_t) job->keys[u];
+  }
+  free(job->keys);
+  job->keys = NULL;
+  job->tail = job->reached;
+  return job->degrees;
+}
+
+/* Breadth-first pass from the queued seeds.  Returns the sum of the
+ * connection counts of the cells reached, which is twice the number of
+ * cells reached less one if, and only if, they form a tree. */
+static size_t SpreadDistJob(dist_job_t *job)
+{
+  size_t head, level_end, degrees;
+  if (job->branching && job->tail > 0) return SpreadDistBranches(job);
+  degrees = 0;
+  for (head = 0; head < job->tail; head = level_end)
+  {
+    level_end = job->tail;
+    degrees += SpreadDistLevel(job, head, level_end);
+  }
+  return degrees;
+}
+
+/* Rows of the Maze whose cells are written by one task. */
+typedef struct {
+  maze_t const *maze;
+  dist_job_t const *job;
+  maze_property_t const *properties;
+  uint8_t fields;
+  size_t steps;
+  size_t first_row;
+  size_t end_row;
+  int64_t maxes[DIST_FIELD_COUNT];
+} dist_band_t;
+
+/* Thread Pool task.  Writes the fields of the band's rows and their
+ * largest values. */
+static void StoreDistBand(void *arg)
+{
+  dist_band_t *band;
+  dist_job_t const *job;
+  point_t pos;
+  maze_cell_t *cell;
+  int64_t values[DIST_FIELD_COUNT];
+  size_t idx, f;
+  band = (dist_band_t*)arg;
+  job = band->job;
+  idx = band->first_row * job->width;
+  for (pos.row = band->first_row; pos.row < band->end_row; pos.row++)
+  for (pos.col = 0; pos.col < job->width; pos.col++, idx++)
+  {
+    cell = GetMazeCell(band->maze, &pos);
+    if (!cell) continue;
+    if (job->dist[idx] == DIST_UNSEEN)
+    {
+      for (f = 0; f < DIST_FIELD_COUNT; f++) values[f] = 0;
+    }
+    else
+    {
+      values[MAZE_DIST_PATH] = (int64_t) job->dist[idx] + 1;
+      values[MAZE_DIST_START] = values[MAZE_DIST_PATH];
+      values[MAZE_DIST_END] = values[MAZE_DIST_PATH];
+      values[DIST_FIELD_OWNER] = 0;
+      if (job->anchor)
+      {
+        values[MAZE_DIST_START] += job->anchor[idx];
+        values[MAZE_DIST_END] += (int64_t) (band->steps - job->anchor[idx]);
+        values[DIST_FIELD_OWNER] = (int64_t) job->anchor[idx] + 1;
+      }
+    }
+    for (f = 0; f < DIST_FIELD_COUNT; f++)
+    {
+      if (!(band->fields & MazeDistFieldMask(f))) continue;
+      SetMazeCellProperty(cell, band->properties[f], values[f]);
+      if (values[f] > band->maxes[f]) band->maxes[f] = values[f];
+    }
+  }
+}
+
+/* Writes the `fields` of every cell from the pass into `properties`,
+ * in bands of rows on the Thread Pool if the job has one.  With
+ * anchors, the start and end fields add the steps along a path of
+ * `steps` steps. */
+static void StoreDistJob(
+  maze_t const *maze, dist_job_t const *job, maze_property_t const *properties,
+  uint8_t fields, size_t steps, int64_t *maxes)
+{
+  dist_band_t *bands;
+  size_t i, f, count, rows;
+  count = job->pool ? ThreadPoolSize(job->pool) * kDistBranchesPerThread : 1;
+  if (count > job->height) count = job->height;
+  rows = (job->height + count - 1) / count;
+  bands = (dist_band_t*)calloc(count, sizeof(dist_band_t));
+  for (i = 0; i < count; i++)
+  {
+    bands[i].maze = maze;
+    bands[i].job = job;
+    bands[i].properties = properties;
+    bands[i].fields = fields;
+    bands[i].steps = steps;
+    bands[i].first_row = i * rows < job->height ? i * rows : job->height;
+    bands[i].end_row = (i + 1) * rows < job->height ? (i + 1) * rows : job->height;
+    if (!job->pool || !SubmitThreadTask(job->pool, StoreDistBand, &bands[i]))
+      StoreDistBand(&bands[i]);
+  }
+  if (job->pool) WaitThreadPool(job->pool);
+  for (f = 0; f < DIST_FIELD_COUNT; f++)
+  {
+    if (!(fields & MazeDistFieldMask(f))) continue;
+    maxes[f] = 0;
+    for (i = 0; i < count; i++)
+    {
+      if (bands[i].maxes[f] > maxes[f]) maxes[f] = bands[i].maxes[f];
+    }
+  }
+  free(bands);
+}
+
+/* Whether the Maze has fewer passages than cells, as a Maze without
+ * loops does.  Passages are counted at the cell below or left of them. */
+static bool_t HasDistJobFewPassages(dist_job_t const *job)
+{
+  size_t i, passages;
+  passages = 0;
+  for (i = 0; i < job->count; i++)
+  {
+    passages += CountConns(job->conns[i] & (MAZE_CONN_UP | MAZE_CONN_RIGHT));
+  }
+  return passages < job->count;
+}
+
+/* Sizes the job for `maze`, with a Thread Pool if `threaded` and the
+ * Maze is large enough and has no loops.  Returns false if the Maze is
+ * empty or too large for 32-bit distances. */
+static bool_t StartDistJob(dist_job_t *job, maze_t const *maze, bool_t threaded)
+{
+  memset(job, 0, sizeof(dist_job_t));
+  job->conns = GetMazeConnections(maze);
+  job->height = MazeHeight(maze);
+  job->width = MazeWidth(maze);
+  job->count = job->height * job->width;
+  if (job->count == 0 || job->count >= DIST_UNSEEN) return false;
+  job->dist = (uint32_t*)malloc(job->count * sizeof(uint32_t));
+  job->queue = (size_t*)malloc(job->count * sizeof(size_t));
+  if (threaded && job->count >= kDistParallelCells && HasDistJobFewPassages(job))
+    job->pool = CreateThreadPool(0);
+  if (job->pool)
+  {
+    job->branching = true;
+    job->max_branches = ThreadPoolSize(job->pool) * kDistBranchesPerThread;
+  }
+  return true;
+}
+
+static void EndDistJob(dist_job_t *job)
+{
+  FreeThreadPool(job->pool);
+  free(job->anchor);
+  free(job->queue);
+  free(job->dist);
+  memset(job, 0, sizeof(dist_job_t));
+}
+
+/* Fills one field from a single source, or returns false if the source
+ * is outside the Maze. */
+static bool_t FillSourceDistances(
+  maze_t const *maze, dist_job_t *job, maze_dist_request_t const *request,
+  maze_dist_field_t field, point_t const *source, int64_t *maxes)
+{
+  if (!InsideJob(job, source)) return false;
+  if (request->engine == MAZE_DIST_ENGINE_BIT_PLANES)
+  {
+    FloodMazeDistances(maze, source, 1, job->dist);
+  }
+  else
+  {
+    ResetDistJob(job);
+    SeedDistJob(job, source, 0);
+    SpreadDistJob(job);
+  }
+  StoreDistJob(maze, job, request->properties, MazeDistFieldMask(field), 0, maxes);
+  return true;
+}
+
+/* Fills the path field, and the start and end fields if they can be
+ * derived from the same pass.  Returns the mask of the fields filled. */
+static uint8_t FillPathDistances(
+  maze_t const *maze, dist_job_t *job, maze_dist_request_t const *request,
+  uint8_t fields, int64_t *maxes)
+{
+  point_t path_start, path_end;
+  uint8_t path_fields;
+  size_t degrees, steps;
+  path_fields = 0;
+  job->anchor = (uint32_t*)malloc(job->count * sizeof(uint32_t));
+  ResetDistJob(job);
+  if (SeedDistJobPath(job, request->path))
+  {
+    degrees = SpreadDistJob(job);
+    steps = MazePathLength(request->path) - 1;
+    MazePathStart(request->path, &path_start);
+    MazePathEnd(request->path, &path_end);
+    /* The start and end fields come along if the only way from a cell
+     * to the path's ends is through where it joins the path. */
+    path_fields = fields & MazeDistFieldMask(MAZE_DIST_PATH);
+    if (degrees == 2 * (job->tail - 1)
+        && PointsEqual(&path_start, &request->start)
+        && PointsEqual(&path_end, &request->end))
+    {
+      path_fields = fields;
+    }
+    StoreDistJob(maze, job, request->properties, path_fields, steps, maxes);
+  }
+  free(job->anchor);
+  job->anchor = NULL;
+  return path_fields;
+}
+
+/* Fills the path field by flooding bit-planes, which cannot carry the
+ * path steps along.  Returns the mask of the fields filled. */
+static uint8_t FloodPathDistances(
+  maze_t const *maze, dist_job_t *job, maze_dist_request_t const *request,
+  uint8_t fields, int64_t *maxes)
+{
+  fields &= MazeDistFieldMask(MAZE_DIST_PATH);
+  if (!fields) return 0;
+  if (FloodMazePathDistances(maze, request->path, job->dist) == MAZE_FLOOD_UNREACHED)
+    return 0;
+  StoreDistJob(maze, job, request->properties, fields, 0, maxes);
+  return fields;
+}
+
+/* - - Maze Distance Fields API - - */
+
+bool_t FillMazeDistances(
+  maze_t const *maze, maze_dist_request_t const *request,
+  int64_t maxes[MAZE_DIST_FIELD_COUNT])
+{
+  dist_job_t job;
+  int64_t scratch[MAZE_DIST_FIELD_COUNT];
+  uint8_t fields;
+  size_t f;
+  bool_t ok;
+  if (!maxes) maxes = scratch;
+  for (f = 0; f < MAZE_DIST_FIELD_COUNT; f++) maxes[f] = -1;
+  if (!maze || !request) return false;
+  if (!StartDistJob(&job, maze, request->engine == MAZE_DIST_ENGINE_QUEUE))
+    return false;
+  fields = request->fields & MAZE_DIST_ALL_FIELDS;
+  ok = true;
+  if (request->path && request->engine == MAZE_DIST_ENGINE_BIT_PLANES)
+    fields &= ~FloodPathDistances(maze, &job, request, fields, maxes);
+  else if (request->path)
+    fields &= ~FillPathDistances(maze, &job, request, fields, maxes);
+  if (fields & MazeDistFieldMask(MAZE_DIST_PATH)) ok = false;
+  if (fields & MazeDistFieldMask(MAZE_DIST_START))
+  {
+    ok = FillSourceDistances(
+      maze, &job, request, MAZE_DIST_START, &request->start, maxes) && ok;
+  }
+  if (fields & MazeDistFieldMask(MAZE_DIST_END))
+  {
+    ok = FillSourceDistances(
+      maze, &job, request, MAZE_DIST_END, &request->end, maxes) && ok;
+  }
+  EndDistJob(&job);
+  return ok;
+}
+
+bool_t FillMazeSourceRegions(
+  maze_t const *maze, point_t const *sources, size_t source_count,
+  maze_property_t dist_property, maze_property_t owner_property,
+  int64_t *max)
+{
+  dist_job_t job;
+  maze_property_t properties[DIST_FIELD_COUNT];
+  int64_t maxes[DIST_FIELD_COUNT], scratch;
+  size_t i;
+  if (!max) max = &scratch;
+  *max = -1;
+  if (!maze || !sources || source_count == 0) return false;
+  if (source_count >= DIST_UNSEEN) return false;
+  if (!StartDistJob(&job, maze, true)) return false;
+  for (i = 0; i < source_count; i++)
+  {
+    if (!InsideJob(&job, &sources[i])) break;
+  }
+  if (i < source_count)
+  {
+    EndDistJob(&job);
+    return false;
+  }
+  job.anchor = (uint32_t*)malloc(job.count * sizeof(uint32_t));
+  ResetDistJob(&job);
+  for (i = 0; i < source_count; i++) SeedDistJob(&job, &sources[i], (uint32_t) i);
+  SpreadDistJob(&job);
+  properties[MAZE_DIST_PATH] = dist_property;
+  properties[DIST_FIELD_OWNER] = owner_property;
+  StoreDistJob(maze, &job, properties,
+    MazeDistFieldMask(MAZE_DIST_PATH) | MazeDistFieldMask(DIST_FIELD_OWNER), 0, maxes);
+  *max = maxes[MAZE_DIST_PATH];
+  EndDistJob(&job);
+  return true;
+}
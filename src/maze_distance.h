@@ -0,0 +1,97 @@
+/*
+ * Mazart - Maze Distance Fields
+ *  Module fills cell properties with the number of steps from the
+ *  solution path, the Maze start and the Maze end.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_DISTANCE_H_
+#define _MAZE_DISTANCE_H_
+
+#include "common.h"
+#include "maze.h"
+#include "maze_path.h"
+
+/*
+ * Maze Distance Fields
+ *  A field stores, in a cell property, one more than the number of
+ *  steps from its seed: the path cells, or a single source cell.  A
+ *  seed cell is 1, and a cell that cannot be reached is 0.
+ *
+ *  The traversal works on the raw Maze connections, with flat arrays
+ *  and one queue, and cell properties are only written at the end.
+ *  When the path runs from the start to the end and the cells reached
+ *  form a tree, as in a perfect Maze, every field comes from a single
+ *  pass seeded by the path: a cell's distance from the start or the end
+ *  is its distance to the path plus the steps along the path from where
+ *  it joins.  Otherwise each source gets a pass of its own.
+ *
+ *  On large Mazes with fewer passages than cells, as perfect Mazes have,
+ *  passes are split by branches over worker threads: the subtrees
+ *  hanging off the seeds, such as the path cells, are independent, and
+ *  a worker hands half of its queued cells to a new task while others
+ *  are idle.  Cells are claimed by atomically lowering their distance
+ *  and anchor, packed in one word, so a cell first reached by a longer
+ *  way is spread again.  Other Mazes are spread level by level on the
+ *  calling thread.  The fields are the same either way.
+ */
+typedef enum {
+  MAZE_DIST_PATH,
+  MAZE_DIST_START,
+  MAZE_DIST_END,
+  MAZE_DIST_FIELD_COUNT
+} maze_dist_field_t;
+
+/* How the fields are traversed. */
+typedef enum {
+  /* Breadth-first queue, threaded by branches. */
+  MAZE_DIST_ENGINE_QUEUE,
+  /* Bit-plane flood fill (see maze_flood.h), which does not derive the
+   * start and end fields from the path pass. */
+  MAZE_DIST_ENGINE_BIT_PLANES
+} maze_dist_engine_t;
+
+/* Maze Distance Field to its bit in a field mask. */
+#define MazeDistFieldMask(f) ((uint8_t) (1 << (f)))
+#define MAZE_DIST_ALL_FIELDS \
+  (MazeDistFieldMask(MAZE_DIST_PATH) \
+    | MazeDistFieldMask(MAZE_DIST_START) \
+    | MazeDistFieldMask(MAZE_DIST_END))
+
+typedef struct {
+  /* Mask of the fields to fill. */
+  uint8_t fields;
+  maze_dist_engine_t engine;
+  /* Cell property each field is stored in. */
+  maze_property_t properties[MAZE_DIST_FIELD_COUNT];
+  /* Seed of the path field, from `start` to `end`. */
+  maze_path_t const *path;
+  point_t start;
+  point_t end;
+} maze_dist_request_t;
+
+/* - - Maze Distance Fields API - - */
+
+/* Fills the requested fields of `maze`.  Sets `maxes`, if not NULL, to
+ * the largest value of each field; fields that were not requested, or
+ * not filled, are set to -1.  Returns false if a field could not be
+ * filled, which happens if its seed is missing or outside the Maze. */
+bool_t FillMazeDistances(
+  maze_t const *maze, maze_dist_request_t const *request,
+  int64_t maxes[MAZE_DIST_FIELD_COUNT]);
+
+/* Multi-source fill, for Voronoi regions of the Maze.  One pass from
+ * all of `sources` at once sets `dist_property` of each cell to one more
+ * than the steps to its nearest source, and `owner_property` to one
+ * more than that source's index; a cell equally near to several takes
+ * the smallest index.  Both are 0 for cells that cannot be reached.
+ * Sets `max`, if not NULL, to the largest distance value.  Returns
+ * false if there are no sources or one is outside the Maze. */
+bool_t FillMazeSourceRegions(
+  maze_t const *maze, point_t const *sources, size_t source_count,
+  maze_property_t dist_property, maze_property_t owner_property,
+  int64_t *max);
+
+#endif /* _MAZE_DISTANCE_H_ */
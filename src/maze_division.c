@@ -0,0 +1,162 @@
+/*
+ * Mazart - Recursive Division Maze Generator
+ *  Module provides a task-parallel Maze generator using recursive
+ *  division.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_division.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rng.h"
+#include "thread_pool.h"
+
+/* Regions with fewer cells than this are divided on the current thread
+ * instead of being handed to the pool. */
+static size_t const kDivisionTaskCells = 16384;
+
+/* - - Division Region - - */
+
+typedef struct {
+  maze_conn_t *conns;
+  size_t stride;         /* Maze width. */
+  thread_pool_t *pool;   /* NULL when running serially. */
+  point_t corner;        /* Lowest row and column of the region. */
+  size_t height;
+  size_t width;
+  rng_t rng;
+} division_region_t;
+
+/* - - Division Internal API - - */
+
+static void DivideRegion(division_region_t *region);
+
+static void DivideRegionTask(void *vregion)
+{
+  division_region_t *region;
+  region = vregion;
+  DivideRegion(region);
+  free(region);
+}
+
+/* Closes the wall between rows `row` and `row + 1` of the region,
+ * except at column `gap`. */
+static void CloseDivisionRow(
+  division_region_t const *region, size_t row, size_t gap)
+{
+  maze_conn_t *lower, *upper;
+  size_t col;
+  lower = &region->conns[(region->corner.row + row) * region->stride
+    + region->corner.col];
+  upper = lower + region->stride;
+  for (col = 0; col < region->width; col++)
+  {
+    if (col == gap) continue;
+    lower[col] &= (maze_conn_t) ~MAZE_CONN_UP;
+    upper[col] &= (maze_conn_t) ~MAZE_CONN_DOWN;
+  }
+}
+
+/* Closes the wall between columns `col` and `col + 1` of the region,
+ * except at row `gap`. */
+static void CloseDivisionColumn(
+  division_region_t const *region, size_t col, size_t gap)
+{
+  maze_conn_t *cell;
+  size_t row;
+  cell = &region->conns[region->corner.row * region->stride
+    + region->corner.col + col];
+  for (row = 0; row < region->height; row++, cell += region->stride)
+  {
+    if (row == gap) continue;
+    cell[0] &= (maze_conn_t) ~MAZE_CONN_RIGHT;
+    cell[1] &= (maze_conn_t) ~MAZE_CONN_LEFT;
+  }
+}
+
+/* Splits the region until it is a single corridor.  One half of every
+ * split is processed by a new task (or recursion), and the other half
+ * by this loop. */
+static void DivideRegion(division_region_t *region)
+{
+  division_region_t *half;
+  size_t split;
+  bool_t horizontal;
+  while (region->height > 1 && region->width > 1)
+  {
+    horizontal = region->height > region->width
+      || (region->height == region->width && (NextRng(&region->rng) & 1));
+    half = (division_region_t*)malloc(sizeof(division_region_t));
+    *half = *region;
+    SplitRng(&region->rng, &half->rng);
+    if (horizontal)
+    {
+      split = 1 + NextRngBelow(&region->rng, region->height - 1);
+      CloseDivisionRow(region, split - 1,
+        NextRngBelow(&region->rng, region->width));
+      half->height = split;
+      region->corner.row += split;
+      region->height -= split;
+    }
+    else
+    {
+      split = 1 + NextRngBelow(&region->rng, region->width - 1);
+      CloseDivisionColumn(region, split - 1,
+        NextRngBelow(&region->rng, region->height));
+      half->width = split;
+      region->corner.col += split;
+      region->width -= split;
+    }
+    if (region->pool && half->height * half->width >= kDivisionTaskCells
+        && SubmitThreadTask(region->pool, DivideRegionTask, half))
+    {
+      continue;
+    }
+    DivideRegionTask(half);
+  }
+}
+
+/* - - Division API - - */
+
+void DrawDivisionMaze(maze_t *maze)
+{
+  division_region_t region;
+  maze_conn_t *conns;
+  size_t height, width, row, col;
+  if (!maze) return;
+  height = MazeHeight(maze);
+  width = MazeWidth(maze);
+  conns = GetMazeConnectionsMutable(maze);
+  /* Start with every cell connected to all its neighbours. */
+  for (row = 0; row < height; row++)
+  {
+    for (col = 0; col < width; col++)
+    {
+      conns[row * width + col] =
+        ((row + 1) < height ? MAZE_CONN_UP : 0)
+        | (row > 0 ? MAZE_CONN_DOWN : 0)
+        | (col > 0 ? MAZE_CONN_LEFT : 0)
+        | ((col + 1) < width ? MAZE_CONN_RIGHT : 0);
+    }
+  }
+  memset(&region, 0, sizeof(division_region_t));
+  region.conns = conns;
+  region.stride = width;
+  region.height = height;
+  region.width = width;
+  SplitMazeRng(maze, &region.rng);
+  if (height * width >= 2 * kDivisionTaskCells)
+  {
+    region.pool = CreateThreadPool(0);
+  }
+  DivideRegion(&region);
+  if (region.pool)
+  {
+    WaitThreadPool(region.pool);
+    FreeThreadPool(region.pool);
+  }
+}
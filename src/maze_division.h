@@ -0,0 +1,24 @@
+/*
+ * Mazart - Recursive Division Maze Generator
+ *  Module provides a task-parallel Maze generator using recursive
+ *  division.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_DIVISION_H_
+#define _MAZE_DIVISION_H_
+
+#include "common.h"
+#include "maze.h"
+
+/* Draws the Maze's connections using recursive division.  The Maze
+ * starts fully open and each region is split by a wall with a single
+ * random gap.  The two halves touch disjoint cells, so large halves are
+ * handed to a Thread Pool (see thread_pool.h) and processed without
+ * locks.  Each region has its own random stream seeded from its parent,
+ * so the result does not depend on the number of threads. */
+void DrawDivisionMaze(maze_t *maze);
+
+#endif /* _MAZE_DIVISION_H_ */
@@ -0,0 +1,223 @@
+/*
+ * Mazart - Eller's Maze Generator
+ *  Module provides a row-streaming Maze generator using Eller's
+ *  algorithm.  Only a single row of set labels is kept, so memory use
+ *  is O(width) no matter how many rows are generated.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_eller.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rng.h"
+
+/* - - Eller Generator Structure - - */
+
+struct eller_gen_st {
+  size_t width;
+  size_t row;
+  bool_t finished;
+  /* Random source, rand() unless seeded. */
+  bool_t seeded;
+  rng_t rng;
+  uint64_t bits;       /* Unused random bits of the stream. */
+  size_t bit_count;
+  /* Set label of each column of the current row.  Labels are always
+   * less than width. */
+  size_t *labels;
+  /* Row scratch space, indexed by set label. */
+  size_t *parent;   /* Union-find parent of the label. */
+  size_t *count;    /* Columns of the set not yet given a vertical. */
+  bool_t *has_up;   /* Set already connects to the next row. */
+  bool_t *used;     /* Label is taken in the next row. */
+  /* Columns of the current row that connect to the previous row. */
+  bool_t *carried;
+};
+
+/* - - Eller Generator Internal API - - */
+
+static bool_t RandomEllerBit(eller_gen_t *gen)
+{
+  bool_t bit;
+  if (!gen->seeded) return rand() & 1;
+  if (gen->bit_count == 0)
+  {
+    gen->bits = NextRng(&gen->rng);
+    gen->bit_count = 64;
+  }
+  bit = gen->bits & 1;
+  gen->bits >>= 1;
+  gen->bit_count--;
+  return bit;
+}
+
+static size_t FindEllerSet(eller_gen_t *gen, size_t label)
+{
+  while (gen->parent[label] != label)
+  {
+    gen->parent[label] = gen->parent[gen->parent[label]];
+    label = gen->parent[label];
+  }
+  return label;
+}
+
+/* Gives every column that does not connect to the next row a label
+ * that is not used by any set being carried up. */
+static void RelabelEllerRow(eller_gen_t *gen)
+{
+  size_t col, fresh;
+  memset(gen->used, 0, gen->width * sizeof(bool_t));
+  for (col = 0; col < gen->width; col++)
+  {
+    if (!gen->carried[col]) continue;
+    gen->labels[col] = FindEllerSet(gen, gen->labels[col]);
+    gen->used[gen->labels[col]] = true;
+  }
+  fresh = 0;
+  for (col = 0; col < gen->width; col++)
+  {
+    if (gen->carried[col]) continue;
+    while (gen->used[fresh]) fresh++;
+    gen->labels[col] = fresh;
+    gen->used[fresh] = true;
+  }
+}
+
+/* - - Eller Generator API - - */
+
+eller_gen_t *CreateEllerGenerator(size_t width)
+{
+  eller_gen_t *gen;
+  size_t col;
+  if (width == 0) return NULL;
+  gen = (eller_gen_t*)calloc(1, sizeof(eller_gen_t));
+  gen->width = width;
+  gen->labels = (size_t*)calloc(width, sizeof(size_t));
+  gen->parent = (size_t*)calloc(width, sizeof(size_t));
+  gen->count = (size_t*)calloc(width, sizeof(size_t));
+  gen->has_up = (bool_t*)calloc(width, sizeof(bool_t));
+  gen->used = (bool_t*)calloc(width, sizeof(bool_t));
+  gen->carried = (bool_t*)calloc(width, sizeof(bool_t));
+  /* First row, every cell is its own set. */
+  for (col = 0; col < width; col++) gen->labels[col] = col;
+  return gen;
+}
+
+void FreeEllerGenerator(eller_gen_t *gen)
+{
+  if (!gen) return;
+  free(gen->labels);
+  free(gen->parent);
+  free(gen->count);
+  free(gen->has_up);
+  free(gen->used);
+  free(gen->carried);
+  memset(gen, 0, sizeof(eller_gen_t));
+  free(gen);
+}
+
+void SeedEllerGenerator(eller_gen_t *gen, uint64_t seed)
+{
+  if (!gen) return;
+  gen->seeded = true;
+  SeedRng(&gen->rng, seed);
+  gen->bit_count = 0;
+}
+
+bool_t NextEllerRow(eller_gen_t *gen, bool_t last_row, maze_conn_t *row_conns)
+{
+  size_t width, col, a, b;
+  if (!gen || !row_conns || gen->finished) return false;
+  width = gen->width;
+  for (col = 0; col < width; col++)
+  {
+    gen->parent[col] = col;
+    gen->count[col] = 0;
+    gen->has_up[col] = false;
+    row_conns[col] = gen->carried[col] ? MAZE_CONN_DOWN : 0;
+  }
+  /* Randomly join adjacent cells of different sets.  The last row
+   * must join all of them. */
+  for (col = 0; (col + 1) < width; col++)
+  {
+    a = FindEllerSet(gen, gen->labels[col]);
+    b = FindEllerSet(gen, gen->labels[col + 1]);
+    if (a == b) continue;
+    if (!last_row && RandomEllerBit(gen)) continue;
+    gen->parent[b] = a;
+    row_conns[col] |= MAZE_CONN_RIGHT;
+    row_conns[col + 1] |= MAZE_CONN_LEFT;
+  }
+  gen->row++;
+  if (last_row)
+  {
+    gen->finished = true;
+    return true;
+  }
+  /* Randomly connect cells to the next row, making sure that every set
+   * has at least one connection. */
+  for (col = 0; col < width; col++)
+  {
+    gen->count[FindEllerSet(gen, gen->labels[col])]++;
+  }
+  for (col = 0; col < width; col++)
+  {
+    a = FindEllerSet(gen, gen->labels[col]);
+    gen->count[a]--;
+    gen->carried[col] = RandomEllerBit(gen) || (gen->count[a] == 0 && !gen->has_up[a]);
+    if (!gen->carried[col]) continue;
+    gen->has_up[a] = true;
+    row_conns[col] |= MAZE_CONN_UP;
+  }
+  RelabelEllerRow(gen);
+  return true;
+}
+
+size_t EllerRowCount(eller_gen_t const *gen)
+{
+  if (!gen) return 0;
+  return gen->row;
+}
+
+bool_t StreamEllerMaze(
+  size_t height, size_t width, eller_row_cb_t row_cb, void *ctx)
+{
+  eller_gen_t *gen;
+  maze_conn_t *row_conns;
+  size_t row;
+  if (height == 0 || width == 0 || !row_cb) return false;
+  gen = CreateEllerGenerator(width);
+  row_conns = (maze_conn_t*)calloc(width, sizeof(maze_conn_t));
+  for (row = 0; row < height; row++)
+  {
+    NextEllerRow(gen, (row + 1) == height, row_conns);
+    if (!row_cb(ctx, row, row_conns, width)) break;
+  }
+  free(row_conns);
+  FreeEllerGenerator(gen);
+  return row == height;
+}
+
+void DrawEllerMaze(maze_t *maze)
+{
+  eller_gen_t *gen;
+  maze_conn_t *conns;
+  rng_t rng;
+  size_t height, width, row;
+  if (!maze) return;
+  height = MazeHeight(maze);
+  width = MazeWidth(maze);
+  conns = GetMazeConnectionsMutable(maze);
+  gen = CreateEllerGenerator(width);
+  SplitMazeRng(maze, &rng);
+  SeedEllerGenerator(gen, NextRng(&rng));
+  for (row = 0; row < height; row++)
+  {
+    NextEllerRow(gen, (row + 1) == height, &conns[row * width]);
+  }
+  FreeEllerGenerator(gen);
+}
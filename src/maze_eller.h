@@ -0,0 +1,71 @@
+/*
+ * Mazart - Eller's Maze Generator
+ *  Module provides a row-streaming Maze generator using Eller's
+ *  algorithm.  Only a single row of set labels is kept, so memory use
+ *  is O(width) no matter how many rows are generated.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_ELLER_H_
+#define _MAZE_ELLER_H_
+
+#include "common.h"
+#include "maze.h"
+
+/*
+ * Eller Generator Struct
+ *  Holds the state needed to produce the next row of a perfect Maze.
+ *  Rows are produced as arrays of Maze Connection masks, one mask per
+ *  column, which include the connections to the previous row (down)
+ *  and the next row (up).
+ */
+typedef struct eller_gen_st eller_gen_t;
+
+/*
+ * Eller Row callback function type.
+ * Parameters:
+ *  (void*)
+ *    - Callback context provided by the programmer.  Maybe NULL.
+ *  (size_t)
+ *    - Row index, starting at 0.
+ *  (maze_conn_t const *)
+ *    - Connection masks of the row.  The buffer is reused for the next
+ *      row and must be copied if needed after the callback returns.
+ *  (size_t)
+ *    - Width of the row.
+ * Results:
+ *    - Return true to continue generating rows, false to stop early.
+ */
+typedef bool_t (*eller_row_cb_t)(void *, size_t, maze_conn_t const *, size_t);
+
+/* - - Eller Generator API - - */
+
+/* Eller Generator constructor.  Width must be non-zero.  Random
+ * choices use rand() until the generator is seeded. */
+eller_gen_t *CreateEllerGenerator(size_t width);
+void FreeEllerGenerator(eller_gen_t *gen);
+/* Gives the generator its own random stream.  Should be called before
+ * the first row is generated. */
+void SeedEllerGenerator(eller_gen_t *gen, uint64_t seed);
+
+/* Generates the next row into `row_conns` (must fit `width` masks).
+ * Set `last_row` for the final row, it joins all remaining sets and
+ * has no connections to a next row.  Returns false once the last row
+ * has been generated. */
+bool_t NextEllerRow(eller_gen_t *gen, bool_t last_row, maze_conn_t *row_conns);
+/* Number of rows generated so far. */
+size_t EllerRowCount(eller_gen_t const *gen);
+
+/* Generates a `height` x `width` Maze, passing each row to `row_cb`.
+ * The full Maze is never stored.  Returns true if every row was
+ * generated. */
+bool_t StreamEllerMaze(
+  size_t height, size_t width, eller_row_cb_t row_cb, void *ctx);
+
+/* Draws the Maze's connections using Eller's algorithm.  The Maze
+ * connections are expected to be cleared. */
+void DrawEllerMaze(maze_t *maze);
+
+#endif /* _MAZE_ELLER_H_ */
@@ -0,0 +1,226 @@
+/*
+ * Mazart - Maze File
+ *  Module provides a compact on-disk Maze format, which is written and
+ *  read one row at a time so Mazes larger than memory can be generated
+ *  and rendered.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "maze_eller.h"
+
+#define MAZE_FILE_HEADER_SZ 32
+#define CELLS_PER_BYTE 4
+
+static uint8_t const kMazeFileMagic[8] = {'M', 'A', 'Z', 'A', 'R', 'T', 0, 1};
+
+/* Bits of a cell in its row byte. */
+#define FILE_BIT_UP 0x1
+#define FILE_BIT_RIGHT 0x2
+
+/* - - Maze File Structure - - */
+
+struct maze_file_st {
+  FILE *fp;
+  bool_t writing;
+  bool_t failed;
+  size_t height;
+  size_t width;
+  size_t row;           /* Next row to read or write. */
+  size_t row_bytes;
+  uint8_t *packed;      /* Current row. */
+  uint8_t *last;        /* Previous row, when reading. */
+};
+
+/* - - Maze File Internal API - - */
+
+static void EncodeFileWord(uint8_t *buf, uint64_t value)
+{
+  size_t i;
+  for (i = 0; i < 8; i++) buf[i] = (uint8_t) (value >> (8 * i));
+}
+
+static uint64_t DecodeFileWord(uint8_t const *buf)
+{
+  uint64_t value;
+  size_t i;
+  value = 0;
+  for (i = 0; i < 8; i++) value |= ((uint64_t) buf[i]) << (8 * i);
+  return value;
+}
+
+static inline uint8_t GetPackedCell(uint8_t const *packed, size_t col)
+{
+  return (packed[col / CELLS_PER_BYTE] >> (2 * (col % CELLS_PER_BYTE))) & 0x3;
+}
+
+static maze_file_t *AllocateMazeFile(
+  FILE *fp, bool_t writing, size_t height, size_t width)
+{
+  maze_file_t *file;
+  file = (maze_file_t*)calloc(1, sizeof(maze_file_t));
+  file->fp = fp;
+  file->writing = writing;
+  file->height = height;
+  file->width = width;
+  file->row_bytes = (width + CELLS_PER_BYTE - 1) / CELLS_PER_BYTE;
+  file->packed = (uint8_t*)calloc(file->row_bytes, sizeof(uint8_t));
+  file->last = (uint8_t*)calloc(file->row_bytes, sizeof(uint8_t));
+  return file;
+}
+
+/* - - Maze File API - - */
+
+maze_file_t *CreateMazeFile(char const *path, size_t height, size_t width)
+{
+  FILE *fp;
+  uint8_t header[MAZE_FILE_HEADER_SZ];
+  if (!path || height == 0 || width == 0) return NULL;
+  fp = fopen(path, "wb");
+  if (!fp) return NULL;
+  memset(header, 0, sizeof(header));
+  memcpy(header, kMazeFileMagic, sizeof(kMazeFileMagic));
+  EncodeFileWord(&header[8], height);
+  EncodeFileWord(&header[16], width);
+  if (fwrite(header, 1, sizeof(header), fp) != sizeof(header))
+  {
+    fclose(fp);
+    return NULL;
+  }
+  return AllocateMazeFile(fp, true, height, width);
+}
+
+maze_file_t *OpenMazeFile(char const *path)
+{
+  FILE *fp;
+  uint8_t header[MAZE_FILE_HEADER_SZ];
+  size_t height, width;
+  if (!path) return NULL;
+  fp = fopen(path, "rb");
+  if (!fp) return NULL;
+  if (fread(header, 1, sizeof(header), fp) != sizeof(header)
+      || memcmp(header, kMazeFileMagic, sizeof(kMazeFileMagic)) != 0)
+  {
+    fclose(fp);
+    return NULL;
+  }
+  height = (size_t) DecodeFileWord(&header[8]);
+  width = (size_t) DecodeFileWord(&header[16]);
+  if (height == 0 || width == 0)
+  {
+    fclose(fp);
+    return NULL;
+  }
+  return AllocateMazeFile(fp, false, height, width);
+}
+
+bool_t CloseMazeFile(maze_file_t *file)
+{
+  bool_t ok;
+  if (!file) return false;
+  ok = !file->failed;
+  if (file->writing && file->row != file->height) ok = false;
+  if (fclose(file->fp) != 0) ok = false;
+  free(file->packed);
+  free(file->last);
+  memset(file, 0, sizeof(maze_file_t));
+  free(file);
+  return ok;
+}
+
+size_t MazeFileHeight(maze_file_t const *file)
+{
+  if (!file) return 0;
+  return file->height;
+}
+
+size_t MazeFileWidth(maze_file_t const *file)
+{
+  if (!file) return 0;
+  return file->width;
+}
+
+bool_t WriteMazeFileRow(maze_file_t *file, maze_conn_t const *row_conns)
+{
+  size_t col;
+  uint8_t bits;
+  if (!file || !row_conns || !file->writing || file->failed) return false;
+  if (file->row >= file->height) return false;
+  memset(file->packed, 0, file->row_bytes);
+  for (col = 0; col < file->width; col++)
+  {
+    bits = 0;
+    if (row_conns[col] & MAZE_CONN_UP) bits |= FILE_BIT_UP;
+    if (row_conns[col] & MAZE_CONN_RIGHT) bits |= FILE_BIT_RIGHT;
+    file->packed[col / CELLS_PER_BYTE] |=
+      (uint8_t) (bits << (2 * (col % CELLS_PER_BYTE)));
+  }
+  if (fwrite(file->packed, 1, file->row_bytes, file->fp) != file->row_bytes)
+  {
+    file->failed = true;
+    return false;
+  }
+  file->row++;
+  return true;
+}
+
+bool_t ReadMazeFileRow(maze_file_t *file, maze_conn_t *row_conns)
+{
+  uint8_t *swap, bits;
+  size_t col;
+  if (!file || !row_conns || file->writing || file->failed) return false;
+  if (file->row >= file->height) return false;
+  swap = file->last;
+  file->last = file->packed;
+  file->packed = swap;
+  if (fread(file->packed, 1, file->row_bytes, file->fp) != file->row_bytes)
+  {
+    file->failed = true;
+    return false;
+  }
+  for (col = 0; col < file->width; col++)
+  {
+    bits = GetPackedCell(file->packed, col);
+    row_conns[col] = 0;
+    if (bits & FILE_BIT_UP) row_conns[col] |= MAZE_CONN_UP;
+    if (bits & FILE_BIT_RIGHT) row_conns[col] |= MAZE_CONN_RIGHT;
+    if (col > 0 && (GetPackedCell(file->packed, col - 1) & FILE_BIT_RIGHT))
+      row_conns[col] |= MAZE_CONN_LEFT;
+    if (file->row > 0 && (GetPackedCell(file->last, col) & FILE_BIT_UP))
+      row_conns[col] |= MAZE_CONN_DOWN;
+  }
+  file->row++;
+  return true;
+}
+
+/* - - Out-of-Core Generation - - */
+
+bool_t GenerateMazeFile(
+  char const *path, size_t height, size_t width, uint64_t seed)
+{
+  maze_file_t *file;
+  eller_gen_t *gen;
+  maze_conn_t *row_conns;
+  bool_t ok;
+  file = CreateMazeFile(path, height, width);
+  if (!file) return false;
+  gen = CreateEllerGenerator(width);
+  SeedEllerGenerator(gen, seed);
+  row_conns = (maze_conn_t*)calloc(width, sizeof(maze_conn_t));
+  ok = true;
+  while (ok && EllerRowCount(gen) < height)
+  {
+    NextEllerRow(gen, EllerRowCount(gen) + 1 == height, row_conns);
+    ok = WriteMazeFileRow(file, row_conns);
+  }
+  free(row_conns);
+  FreeEllerGenerator(gen);
+  return CloseMazeFile(file) && ok;
+}
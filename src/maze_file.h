@@ -0,0 +1,63 @@
+/*
+ * Mazart - Maze File
+ *  Module provides a compact on-disk Maze format, which is written and
+ *  read one row at a time so Mazes larger than memory can be generated
+ *  and rendered.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_FILE_H_
+#define _MAZE_FILE_H_
+
+#include "common.h"
+#include "maze.h"
+
+/*
+ * Maze File
+ *  A 32 byte header (magic, height and width as little-endian 64-bit
+ *  values, and a reserved word) followed by the rows in order.  Only
+ *  the up and right connection of each cell is stored, 2 bits per
+ *  cell and 4 cells per byte, the down and left connections are taken
+ *  from the neighbours when reading.  A 100k x 100k Maze is 2.5 GB.
+ *
+ *  A Maze File is opened either for writing or for reading, and rows
+ *  are always accessed in order, so only a couple of rows are ever in
+ *  memory.
+ */
+typedef struct maze_file_st maze_file_t;
+
+/* - - Maze File API - - */
+
+/* Creates the file at `path` for writing a `height` x `width` Maze.
+ * Returns NULL if the file cannot be created. */
+maze_file_t *CreateMazeFile(char const *path, size_t height, size_t width);
+/* Opens an existing Maze File for reading.  Returns NULL if the file
+ * cannot be opened or is not a Maze File. */
+maze_file_t *OpenMazeFile(char const *path);
+/* Closes the file.  Returns false if writing failed or fewer rows than
+ * the Maze height were written. */
+bool_t CloseMazeFile(maze_file_t *file);
+
+/* Maze dimension getters. */
+size_t MazeFileHeight(maze_file_t const *file);
+size_t MazeFileWidth(maze_file_t const *file);
+
+/* Appends the next row, `row_conns` holds MazeFileWidth() Maze
+ * Connection masks.  Returns false on a write error or once every row
+ * was written. */
+bool_t WriteMazeFileRow(maze_file_t *file, maze_conn_t const *row_conns);
+/* Reads the next row into `row_conns`, which must fit MazeFileWidth()
+ * masks.  Returns false on a read error or once every row was read. */
+bool_t ReadMazeFileRow(maze_file_t *file, maze_conn_t *row_conns);
+
+/* - - Out-of-Core Generation - - */
+
+/* Generates a `height` x `width` perfect Maze straight into a Maze File
+ * at `path`, using Eller's algorithm seeded with `seed`.  Memory use
+ * only depends on the width.  Returns false on a file error. */
+bool_t GenerateMazeFile(
+  char const *path, size_t height, size_t width, uint64_t seed);
+
+#endif /* _MAZE_FILE_H_ */
@@ -0,0 +1,201 @@
+/*
+ * Mazart - Maze Bit-plane Flood Fill
+ *  Module provides a bit-parallel breadth-first flood fill, which
+ *  advances the frontier 64 cells per word operation.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_flood.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CELLS_PER_WORD 64
+
+/* - - Maze Flood Structures - - */
+
+typedef struct {
+  size_t height;
+  size_t width;
+  size_t row_words;     /* Words per row. */
+  size_t words;
+  uint64_t *right;      /* Open to the right. */
+  uint64_t *up;         /* Open up, to the next row. */
+  uint64_t *seen;
+  uint64_t *front;
+  uint64_t *next;
+  size_t *active;       /* Words with frontier bits. */
+  size_t active_count;
+  size_t *touched;      /* Words with next level bits. */
+  size_t touched_count;
+  uint32_t *dist;
+} maze_flood_t;
+
+/* - - Maze Flood Internal API - - */
+
+/* Packs the connections into bit-planes.  Returns false if the Maze is
+ * empty. */
+static bool_t StartFlood(maze_flood_t *flood, maze_t const *maze, uint32_t *dist)
+{
+  maze_conn_t const *conns, *cells;
+  size_t row, word, i, n, count;
+  uint64_t right, up;
+  memset(flood, 0, sizeof(maze_flood_t));
+  flood->height = MazeHeight(maze);
+  flood->width = MazeWidth(maze);
+  count = flood->height * flood->width;
+  if (count == 0 || count >= MAZE_FLOOD_UNREACHED) return false;
+  flood->row_words = (flood->width + CELLS_PER_WORD - 1) / CELLS_PER_WORD;
+  flood->words = flood->height * flood->row_words;
+  flood->right = (uint64_t*)calloc(flood->words, sizeof(uint64_t));
+  flood->up = (uint64_t*)calloc(flood->words, sizeof(uint64_t));
+  flood->seen = (uint64_t*)calloc(flood->words, sizeof(uint64_t));
+  flood->front = (uint64_t*)calloc(flood->words, sizeof(uint64_t));
+  flood->next = (uint64_t*)calloc(flood->words, sizeof(uint64_t));
+  flood->active = (size_t*)malloc(flood->words * sizeof(size_t));
+  flood->touched = (size_t*)malloc(flood->words * sizeof(size_t));
+  flood->dist = dist;
+  conns = GetMazeConnections(maze);
+  for (row = 0; row < flood->height; row++)
+  for (word = 0; word < flood->row_words; word++)
+  {
+    cells = &conns[row * flood->width + word * CELLS_PER_WORD];
+    n = flood->width - word * CELLS_PER_WORD;
+    if (n > CELLS_PER_WORD) n = CELLS_PER_WORD;
+    right = up = 0;
+    for (i = 0; i < n; i++)
+    {
+      right |= ((uint64_t) ((cells[i] >> MAZE_DIR_RIGHT) & 1)) << i;
+      up |= ((uint64_t) ((cells[i] >> MAZE_DIR_UP) & 1)) << i;
+    }
+    flood->right[row * flood->row_words + word] = right;
+    flood->up[row * flood->row_words + word] = up;
+  }
+  memset(dist, 0xFF, count * sizeof(uint32_t));
+  return true;
+}
+
+static void EndFlood(maze_flood_t *flood)
+{
+  free(flood->right);
+  free(flood->up);
+  free(flood->seen);
+  free(flood->front);
+  free(flood->next);
+  free(flood->active);
+  free(flood->touched);
+  memset(flood, 0, sizeof(maze_flood_t));
+}
+
+static void SeedFlood(maze_flood_t *flood, point_t const *pos)
+{
+  size_t word;
+  uint64_t bit;
+  if (pos->row >= flood->height || pos->col >= flood->width) return;
+  word = pos->row * flood->row_words + pos->col / CELLS_PER_WORD;
+  bit = ((uint64_t) 1) << (pos->col % CELLS_PER_WORD);
+  if (flood->seen[word] & bit) return;
+  if (!flood->front[word]) flood->active[flood->active_count++] = word;
+  flood->seen[word] |= bit;
+  flood->front[word] |= bit;
+  flood->dist[pos->row * flood->width + pos->col] = 0;
+}
+
+/* Adds `bits` of `word` that have not been seen to the next level. */
+static inline void ReachFlood(maze_flood_t *flood, size_t word, uint64_t bits)
+{
+  bits &= ~flood->seen[word];
+  if (!bits) return;
+  if (!flood->next[word]) flood->touched[flood->touched_count++] = word;
+  flood->next[word] |= bits;
+}
+
+/* Advances the frontier by one level at distance `level`.  Returns
+ * false if the next level is empty. */
+static bool_t StepFlood(maze_flood_t *flood, uint32_t level)
+{
+  size_t i, k, row, col, *swap;
+  uint64_t f, bits;
+  flood->touched_count = 0;
+  for (i = 0; i < flood->active_count; i++)
+  {
+    k = flood->active[i];
+    f = flood->front[k];
+    flood->front[k] = 0;
+    row = k / flood->row_words;
+    col = k % flood->row_words;
+    /* Right, from a cell open to the right; bit 63 carries over. */
+    bits = f & flood->right[k];
+    ReachFlood(flood, k, bits << 1);
+    if ((bits >> 63) && col + 1 < flood->row_words) ReachFlood(flood, k + 1, 1);
+    /* Left, into a cell open to the right; bit 0 carries back. */
+    ReachFlood(flood, k, (f >> 1) & flood->right[k]);
+    if ((f & 1) && col > 0)
+      ReachFlood(flood, k - 1, (((uint64_t) 1) << 63) & flood->right[k - 1]);
+    /* Up, from a cell open up; down, into a cell open up. */
+    if (row + 1 < flood->height) ReachFlood(flood, k + flood->row_words, f & flood->up[k]);
+    if (row > 0) ReachFlood(flood, k - flood->row_words, f & flood->up[k - flood->row_words]);
+  }
+  for (i = 0; i < flood->touched_count; i++)
+  {
+    k = flood->touched[i];
+    bits = flood->next[k];
+    flood->next[k] = 0;
+    flood->seen[k] |= bits;
+    flood->front[k] = bits;
+    row = k / flood->row_words;
+    col = (k % flood->row_words) * CELLS_PER_WORD;
+    for (; bits; bits &= bits - 1)
+    {
+      flood->dist[row * flood->width + col + (size_t) __builtin_ctzll(bits)] = level;
+    }
+  }
+  swap = flood->active;
+  flood->active = flood->touched;
+  flood->touched = swap;
+  flood->active_count = flood->touched_count;
+  return flood->active_count > 0;
+}
+
+/* Floods from the seeded frontier.  Returns the largest distance. */
+static uint32_t RunFlood(maze_flood_t *flood)
+{
+  uint32_t level;
+  if (flood->active_count == 0) return MAZE_FLOOD_UNREACHED;
+  for (level = 1; StepFlood(flood, level); level++);
+  return level - 1;
+}
+
+/* - - Maze Flood Fill API - - */
+
+uint32_t FloodMazeDistances(
+  maze_t const *maze, point_t const *seeds, size_t seed_count,
+  uint32_t *dist)
+{
+  maze_flood_t flood;
+  uint32_t max;
+  size_t i;
+  if (!maze || !seeds || !dist) return MAZE_FLOOD_UNREACHED;
+  if (!StartFlood(&flood, maze, dist)) return MAZE_FLOOD_UNREACHED;
+  for (i = 0; i < seed_count; i++) SeedFlood(&flood, &seeds[i]);
+  max = RunFlood(&flood);
+  EndFlood(&flood);
+  return max;
+}
+
+uint32_t FloodMazePathDistances(
+  maze_t const *maze, maze_path_t const *path, uint32_t *dist)
+{
+  maze_flood_t flood;
+  maze_path_iter_t iter;
+  uint32_t max;
+  if (!maze || !path || !dist) return MAZE_FLOOD_UNREACHED;
+  if (!StartFlood(&flood, maze, dist)) return MAZE_FLOOD_UNREACHED;
+  StartMazePathIter(&iter, path);
+  while (NextMazePathIter(&iter)) SeedFlood(&flood, &iter.pos);
+  max = RunFlood(&flood);
+  EndFlood(&flood);
+  return max;
+}
@@ -0,0 +1,49 @@
+/*
+ * Mazart - Maze Bit-plane Flood Fill
+ *  Module provides a bit-parallel breadth-first flood fill, which
+ *  advances the frontier 64 cells per word operation.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_FLOOD_H_
+#define _MAZE_FLOOD_H_
+
+#include "common.h"
+#include "maze.h"
+#include "maze_path.h"
+
+/* Distance of a cell the flood did not reach. */
+#define MAZE_FLOOD_UNREACHED UINT32_MAX
+
+/*
+ * Maze Bit-plane Flood Fill
+ *  The Maze connections are first packed into two bit-planes, one bit
+ *  per cell: open to the right and open up.  The frontier, the next
+ *  level and the visited cells are bit-planes of the same shape.  A
+ *  level is advanced word by word: the frontier is shifted left and
+ *  right within its row (carrying across words), and moved to the rows
+ *  above and below, each move masked with the passage bits and with
+ *  the cells not yet visited.
+ *
+ *  Only the words with frontier bits are visited, so a narrow frontier
+ *  costs as little as the words it touches.  Every cell of a level is
+ *  then given its distance, one set bit at a time.
+ */
+
+/* - - Maze Flood Fill API - - */
+
+/* Fills `dist` (MazeHeight() x MazeWidth(), row-major) with the steps
+ * from the nearest of `seeds`, or MAZE_FLOOD_UNREACHED.  Seeds outside
+ * the Maze are ignored.  Returns the largest distance, or
+ * MAZE_FLOOD_UNREACHED if no seed is in the Maze. */
+uint32_t FloodMazeDistances(
+  maze_t const *maze, point_t const *seeds, size_t seed_count,
+  uint32_t *dist);
+
+/* As FloodMazeDistances(), seeded with every cell of `path`. */
+uint32_t FloodMazePathDistances(
+  maze_t const *maze, maze_path_t const *path, uint32_t *dist);
+
+#endif /* _MAZE_FLOOD_H_ */
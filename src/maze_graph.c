@@ -0,0 +1,498 @@
+/*
+ * Mazart - Maze Corridor Graph
+ *  Module provides a parallel dead-end filling solver, and a contracted
+ *  graph of a Maze's junctions and the corridors between them.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_graph.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "thread_pool.h"
+
+/* Mazes with fewer cells than this are processed on the calling
+ * thread. */
+static size_t const kGraphParallelCells = 65536;
+/* Number of bands per worker thread, for load balancing. */
+static size_t const kGraphBandsPerThread = 4;
+/* Initial capacity of the work lists, grows by doubling. */
+static size_t const kGraphListSize = 64;
+
+/* Cell marks of the dead-end filler, one byte per cell.  The low 4
+ * bits are the connections to filled neighbours. */
+#define FILL_DEAD 0x0F
+#define FILL_KEEP 0x10
+#define FILL_DONE 0x20
+
+/* - - Maze Graph Structures - - */
+
+struct maze_graph_st {
+  size_t height;
+  size_t width;
+  size_t node_count;
+  size_t edge_count;
+  size_t *cells;              /* Cell index of each node, ascending. */
+  size_t *offsets;            /* First edge of each node, plus the end. */
+  maze_graph_edge_t *edges;
+};
+
+/* Growable list of cell indices. */
+typedef struct {
+  size_t *items;
+  size_t size;
+  size_t capacity;
+} graph_list_t;
+
+/* Shared state of a dead-end fill or a graph build. */
+typedef struct {
+  maze_conn_t const *conns;
+  size_t height;
+  size_t width;
+  size_t band_rows;
+  uint8_t *marks;
+  maze_graph_t *graph;
+} graph_job_t;
+
+typedef struct {
+  graph_job_t *job;
+  size_t first_row;
+  size_t end_row;
+  bool_t scanned;
+  graph_list_t work;    /* Cells of the band that may be dead ends. */
+  graph_list_t outbox;  /* Fills of other bands' neighbours, as
+                         * `cell * 4 + dir` of the filled neighbour. */
+  size_t count;
+} graph_band_t;
+
+/* - - Maze Graph Internal API - - */
+
+static void PushGraphList(graph_list_t *list, size_t item)
+{
+  if (list->size == list->capacity)
+  {
+    list->capacity = list->capacity ? 2 * list->capacity : kGraphListSize;
+    list->items = (size_t*)realloc(list->items, list->capacity * sizeof(size_t));
+  }
+  list->items[list->size++] = item;
+}
+
+static inline size_t CountConns(maze_conn_t conns)
+{
+  return (size_t) __builtin_popcount(conns);
+}
+
+/* Open connections of `idx` to cells that are not filled. */
+static inline maze_conn_t LiveConns(graph_job_t const *job, size_t idx)
+{
+  return job->conns[idx] & ~(job->marks[idx] & FILL_DEAD);
+}
+
+static inline bool_t IsDeadEnd(graph_job_t const *job, size_t idx)
+{
+  return !(job->marks[idx] & (FILL_KEEP | FILL_DONE))
+    && CountConns(LiveConns(job, idx)) == 1;
+}
+
+static inline bool_t IsGraphNode(graph_job_t const *job, size_t idx)
+{
+  return (job->marks[idx] & FILL_KEEP) || CountConns(job->conns[idx]) != 2;
+}
+
+/* Splits the rows into bands, and creates a pool if the Maze is large
+ * enough to be worth it. */
+static graph_band_t *CreateGraphBands(
+  graph_job_t *job, thread_pool_t **pool, size_t *band_count)
+{
+  graph_band_t *bands;
+  size_t i;
+  *pool = NULL;
+  *band_count = 1;
+  if (job->height * job->width >= kGraphParallelCells)
+  {
+    *pool = CreateThreadPool(0);
+    if (*pool) *band_count = ThreadPoolSize(*pool) * kGraphBandsPerThread;
+  }
+  job->band_rows = (job->height + *band_count - 1) / *band_count;
+  *band_count = (job->height + job->band_rows - 1) / job->band_rows;
+  bands = (graph_band_t*)calloc(*band_count, sizeof(graph_band_t));
+  for (i = 0; i < *band_count; i++)
+  {
+    bands[i].job = job;
+    bands[i].first_row = i * job->band_rows;
+    bands[i].end_row = (i + 1) * job->band_rows;
+    if (bands[i].end_row > job->height) bands[i].end_row = job->height;
+  }
+  return bands;
+}
+
+static void FreeGraphBands(graph_band_t *bands, size_t band_count)
+{
+  size_t i;
+  for (i = 0; i < band_count; i++)
+  {
+    free(bands[i].work.items);
+    free(bands[i].outbox.items);
+  }
+  free(bands);
+}
+
+static void RunGraphBands(
+  thread_pool_t *pool, graph_band_t *bands, size_t band_count,
+  thread_task_t task)
+{
+  size_t i;
+  for (i = 0; i < band_count; i++)
+  {
+    if (!pool || !SubmitThreadTask(pool, task, &bands[i])) task(&bands[i]);
+  }
+  WaitThreadPool(pool);
+}
+
+static void MarkKeptCells(
+  graph_job_t *job, point_t const *keep, size_t keep_count)
+{
+  size_t i;
+  if (!keep) return;
+  for (i = 0; i < keep_count; i++)
+  {
+    if (keep[i].row >= job->height || keep[i].col >= job->width) continue;
+    job->marks[keep[i].row * job->width + keep[i].col] |= FILL_KEEP;
+  }
+}
+
+/* - - Dead-end Filling Internal API - - */
+
+/* Fills the band's dead ends until its work list is empty.  Only the
+ * band's own marks are written, fills next to another band are left in
+ * the outbox. */
+static void FillGraphBand(void *vband)
+{
+  graph_band_t *band;
+  graph_job_t *job;
+  size_t first, end, u, v, d;
+  maze_conn_t live;
+  band = vband;
+  job = band->job;
+  first = band->first_row * job->width;
+  end = band->end_row * job->width;
+  if (!band->scanned)
+  {
+    for (u = first; u < end; u++)
+    {
+      if (IsDeadEnd(job, u)) PushGraphList(&band->work, u);
+    }
+    band->scanned = true;
+  }
+  while (band->work.size > 0)
+  {
+    u = band->work.items[--band->work.size];
+    if (!IsDeadEnd(job, u)) continue;
+    live = LiveConns(job, u);
+    job->marks[u] |= FILL_DONE;
+    band->count++;
+    d = (size_t) __builtin_ctz(live);
+    v = StepMazeIndex(u, (maze_dir_t) d, job->width);
+    if (v < first || v >= end)
+    {
+      PushGraphList(&band->outbox, v * MAZE_DIR_COUNT + (d ^ 1));
+      continue;
+    }
+    job->marks[v] |= MazeDirToConn(d ^ 1);
+    if (IsDeadEnd(job, v)) PushGraphList(&band->work, v);
+  }
+}
+
+/* Delivers the fills left in outboxes to the bands that own the
+ * neighbours.  Returns true if any band has more work. */
+static bool_t DeliverGraphOutboxes(graph_band_t *bands, size_t band_count)
+{
+  graph_job_t *job;
+  size_t i, j, v, d;
+  bool_t more;
+  more = false;
+  for (i = 0; i < band_count; i++)
+  {
+    job = bands[i].job;
+    for (j = 0; j < bands[i].outbox.size; j++)
+    {
+      v = bands[i].outbox.items[j] / MAZE_DIR_COUNT;
+      d = bands[i].outbox.items[j] % MAZE_DIR_COUNT;
+      job->marks[v] |= MazeDirToConn(d);
+      if (!IsDeadEnd(job, v)) continue;
+      PushGraphList(&bands[v / job->width / job->band_rows].work, v);
+      more = true;
+    }
+    bands[i].outbox.size = 0;
+  }
+  return more;
+}
+
+/* Runs the dead-end filler over `job`, and returns the number of cells
+ * filled. */
+static size_t FillGraphJob(graph_job_t *job)
+{
+  graph_band_t *bands;
+  thread_pool_t *pool;
+  size_t band_count, count, i;
+  bands = CreateGraphBands(job, &pool, &band_count);
+  do
+  {
+    RunGraphBands(pool, bands, band_count, FillGraphBand);
+  } while (DeliverGraphOutboxes(bands, band_count));
+  count = 0;
+  for (i = 0; i < band_count; i++) count += bands[i].count;
+  FreeGraphBands(bands, band_count);
+  FreeThreadPool(pool);
+  return count;
+}
+
+/* - - Dead-end Filling API - - */
+
+size_t FillMazeDeadEnds(
+  maze_t const *maze, point_t const *keep, size_t keep_count,
+  uint8_t *filled)
+{
+  graph_job_t job;
+  size_t count, i;
+  if (!maze || !filled) return 0;
+  memset(&job, 0, sizeof(graph_job_t));
+  job.conns = GetMazeConnections(maze);
+  job.height = MazeHeight(maze);
+  job.width = MazeWidth(maze);
+  job.marks = (uint8_t*)calloc(job.height * job.width, sizeof(uint8_t));
+  MarkKeptCells(&job, keep, keep_count);
+  count = FillGraphJob(&job);
+  for (i = 0; i < job.height * job.width; i++)
+  {
+    filled[i] = (job.marks[i] & FILL_DONE) ? 1 : 0;
+  }
+  free(job.marks);
+  return count;
+}
+
+maze_path_t *SolveMazeDeadEndFill(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  size_t *filled)
+{
+  graph_job_t job;
+  maze_path_t *path;
+  point_t keep[2];
+  maze_conn_t live;
+  size_t count, u, target, d, steps;
+  if (filled) *filled = 0;
+  if (!maze || !src || !dest) return NULL;
+  if (!GetMazeCell(maze, src) || !GetMazeCell(maze, dest)) return NULL;
+  memset(&job, 0, sizeof(graph_job_t));
+  job.conns = GetMazeConnections(maze);
+  job.height = MazeHeight(maze);
+  job.width = MazeWidth(maze);
+  count = job.height * job.width;
+  job.marks = (uint8_t*)calloc(count, sizeof(uint8_t));
+  keep[0] = *src;
+  keep[1] = *dest;
+  MarkKeptCells(&job, keep, 2);
+  if (filled) *filled = FillGraphJob(&job);
+  else FillGraphJob(&job);
+  /* Follow the cells left from `src`, never stepping back.  In a Maze
+   * with loops the corridor may branch, the first branch is taken and
+   * the walk gives up if it does not reach `dest`. */
+  path = CreateMazePath(src);
+  u = src->row * job.width + src->col;
+  target = dest->row * job.width + dest->col;
+  live = LiveConns(&job, u);
+  for (steps = 0; u != target && live && steps < count; steps++)
+  {
+    d = (size_t) __builtin_ctz(live);
+    PushMazePathStep(path, (maze_dir_t) d);
+    u = StepMazeIndex(u, (maze_dir_t) d, job.width);
+    live = LiveConns(&job, u) & ~MazeDirToConn(d ^ 1);
+  }
+  free(job.marks);
+  if (u != target)
+  {
+    FreeMazePath(path);
+    return NULL;
+  }
+  return path;
+}
+
+/* - - Maze Corridor Graph Internal API - - */
+
+/* Collects the band's nodes, in row-major order. */
+static void FindGraphBandNodes(void *vband)
+{
+  graph_band_t *band;
+  graph_job_t *job;
+  size_t u, end;
+  band = vband;
+  job = band->job;
+  end = band->end_row * job->width;
+  for (u = band->first_row * job->width; u < end; u++)
+  {
+    if (IsGraphNode(job, u)) PushGraphList(&band->work, u);
+  }
+}
+
+static size_t FindGraphNodeIndex(maze_graph_t const *graph, size_t cell)
+{
+  size_t lo, hi, mid;
+  lo = 0;
+  hi = graph->node_count;
+  while (lo < hi)
+  {
+    mid = lo + (hi - lo) / 2;
+    if (graph->cells[mid] < cell) lo = mid + 1;
+    else hi = mid;
+  }
+  if (lo < graph->node_count && graph->cells[lo] == cell) return lo;
+  return SIZE_MAX;
+}
+
+/* Follows every corridor of the band's nodes.  Each node only writes
+ * its own edges. */
+static void WalkGraphBandCorridors(void *vband)
+{
+  graph_band_t *band;
+  graph_job_t *job;
+  maze_graph_t *graph;
+  maze_graph_edge_t *edge;
+  size_t i, node, u, d, came, length, count;
+  band = vband;
+  job = band->job;
+  graph = job->graph;
+  count = job->height * job->width;
+  for (i = 0; i < band->work.size; i++)
+  {
+    node = band->count + i;
+    edge = &graph->edges[graph->offsets[node]];
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      if (!(job->conns[graph->cells[node]] & MazeDirToConn(d))) continue;
+      u = StepMazeIndex(graph->cells[node], (maze_dir_t) d, job->width);
+      came = d ^ 1;
+      /* A corridor cell has exactly two connections, leave by the one
+       * that was not entered by.  The length bound stops on a cycle
+       * without nodes. */
+      for (length = 1; !IsGraphNode(job, u) && length < count; length++)
+      {
+        came = (size_t) __builtin_ctz(job->conns[u] & ~MazeDirToConn(came));
+        u = StepMazeIndex(u, (maze_dir_t) came, job->width);
+        came ^= 1;
+      }
+      edge->node = FindGraphNodeIndex(graph, u);
+      edge->length = length;
+      edge->dir = (maze_dir_t) d;
+      edge++;
+    }
+  }
+}
+
+/* - - Maze Corridor Graph API - - */
+
+maze_graph_t *CreateMazeGraph(
+  maze_t const *maze, point_t const *keep, size_t keep_count)
+{
+  maze_graph_t *graph;
+  graph_job_t job;
+  graph_band_t *bands;
+  thread_pool_t *pool;
+  size_t band_count, i, node;
+  if (!maze) return NULL;
+  graph = (maze_graph_t*)calloc(1, sizeof(maze_graph_t));
+  graph->height = MazeHeight(maze);
+  graph->width = MazeWidth(maze);
+  memset(&job, 0, sizeof(graph_job_t));
+  job.conns = GetMazeConnections(maze);
+  job.height = graph->height;
+  job.width = graph->width;
+  job.marks = (uint8_t*)calloc(job.height * job.width, sizeof(uint8_t));
+  job.graph = graph;
+  MarkKeptCells(&job, keep, keep_count);
+
+  bands = CreateGraphBands(&job, &pool, &band_count);
+  RunGraphBands(pool, bands, band_count, FindGraphBandNodes);
+  /* Bands are in row order, so their nodes are concatenated in order.
+   * Each band remembers its first node in `count`. */
+  for (i = 0; i < band_count; i++)
+  {
+    bands[i].count = graph->node_count;
+    graph->node_count += bands[i].work.size;
+  }
+  graph->cells = (size_t*)malloc((graph->node_count + 1) * sizeof(size_t));
+  graph->offsets = (size_t*)malloc((graph->node_count + 1) * sizeof(size_t));
+  for (i = 0; i < band_count; i++)
+  {
+    memcpy(&graph->cells[bands[i].count], bands[i].work.items,
+      bands[i].work.size * sizeof(size_t));
+  }
+  graph->offsets[0] = 0;
+  for (node = 0; node < graph->node_count; node++)
+  {
+    graph->offsets[node + 1] = graph->offsets[node]
+      + CountConns(job.conns[graph->cells[node]]);
+  }
+  graph->edges = (maze_graph_edge_t*)malloc(
+    (graph->offsets[graph->node_count] + 1) * sizeof(maze_graph_edge_t));
+  graph->edge_count = graph->offsets[graph->node_count] / 2;
+  RunGraphBands(pool, bands, band_count, WalkGraphBandCorridors);
+
+  FreeGraphBands(bands, band_count);
+  FreeThreadPool(pool);
+  free(job.marks);
+  return graph;
+}
+
+void FreeMazeGraph(maze_graph_t *graph)
+{
+  if (!graph) return;
+  free(graph->cells);
+  free(graph->offsets);
+  free(graph->edges);
+  memset(graph, 0, sizeof(maze_graph_t));
+  free(graph);
+}
+
+size_t MazeGraphNodeCount(maze_graph_t const *graph)
+{
+  if (!graph) return 0;
+  return graph->node_count;
+}
+
+size_t MazeGraphEdgeCount(maze_graph_t const *graph)
+{
+  if (!graph) return 0;
+  return graph->edge_count;
+}
+
+bool_t GetMazeGraphNode(maze_graph_t const *graph, size_t node, point_t *pos)
+{
+  if (!graph || !pos || node >= graph->node_count) return false;
+  pos->row = graph->cells[node] / graph->width;
+  pos->col = graph->cells[node] % graph->width;
+  return true;
+}
+
+size_t FindMazeGraphNode(maze_graph_t const *graph, point_t const *pos)
+{
+  if (!graph || !pos) return SIZE_MAX;
+  if (pos->row >= graph->height || pos->col >= graph->width) return SIZE_MAX;
+  return FindGraphNodeIndex(graph, pos->row * graph->width + pos->col);
+}
+
+size_t MazeGraphNodeDegree(maze_graph_t const *graph, size_t node)
+{
+  if (!graph || node >= graph->node_count) return 0;
+  return graph->offsets[node + 1] - graph->offsets[node];
+}
+
+bool_t GetMazeGraphEdge(
+  maze_graph_t const *graph, size_t node, size_t i, maze_graph_edge_t *edge)
+{
+  if (!graph || !edge || i >= MazeGraphNodeDegree(graph, node)) return false;
+  *edge = graph->edges[graph->offsets[node] + i];
+  return true;
+}
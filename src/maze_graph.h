@@ -0,0 +1,80 @@
+/*
+ * Mazart - Maze Corridor Graph
+ *  Module provides a parallel dead-end filling solver, and a contracted
+ *  graph of a Maze's junctions and the corridors between them.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_GRAPH_H_
+#define _MAZE_GRAPH_H_
+
+#include "common.h"
+#include "maze.h"
+#include "maze_path.h"
+
+/*
+ * Maze Corridor Graph
+ *  Every cell that does not have exactly two connections (dead ends
+ *  and junctions), and every kept cell, is a node.  The cells between
+ *  two nodes form a corridor, which is an edge weighted by its number
+ *  of steps.  Nodes are numbered in row-major order of their cells.
+ *
+ *  Corridors are followed from every node, by bands of rows in
+ *  parallel.  A cycle without any node, which a perfect Maze does not
+ *  have, is left out of the graph.
+ */
+typedef struct maze_graph_st maze_graph_t;
+
+/* A corridor, as seen from one of its end nodes. */
+typedef struct {
+  size_t node;      /* Node at the other end. */
+  size_t length;    /* Steps along the corridor. */
+  maze_dir_t dir;   /* First step from this node. */
+} maze_graph_edge_t;
+
+/* - - Dead-end Filling - - */
+
+/* Repeatedly fills dead ends, cells with one open connection that are
+ * not in `keep`, until none are left.  Bands of rows are filled in
+ * parallel, each from its own work list; a fill that opens a dead end
+ * in another band is handed over between rounds.  Sets one byte per
+ * cell of `filled` (MazeHeight() x MazeWidth(), row-major) to 1 for
+ * filled cells, and returns the number of them. */
+size_t FillMazeDeadEnds(
+  maze_t const *maze, point_t const *keep, size_t keep_count,
+  uint8_t *filled);
+
+/* Solves the Maze by filling its dead ends, keeping `src` and `dest`.
+ * In a perfect Maze the cells left are exactly the path.  Returns NULL
+ * if there is no path.  `filled` is optional, and is set to the number
+ * of cells filled. */
+maze_path_t *SolveMazeDeadEndFill(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  size_t *filled);
+
+/* - - Maze Corridor Graph API - - */
+
+/* Maze Corridor Graph constructor.  The `keep` cells are made nodes
+ * even inside a corridor, such as the Maze start and end. */
+maze_graph_t *CreateMazeGraph(
+  maze_t const *maze, point_t const *keep, size_t keep_count);
+void FreeMazeGraph(maze_graph_t *graph);
+
+size_t MazeGraphNodeCount(maze_graph_t const *graph);
+/* Number of corridors, each counted once. */
+size_t MazeGraphEdgeCount(maze_graph_t const *graph);
+
+/* Cell of node `node`.  Returns false if there is no such node. */
+bool_t GetMazeGraphNode(maze_graph_t const *graph, size_t node, point_t *pos);
+/* Node of the cell at `pos`, or SIZE_MAX if the cell is not a node. */
+size_t FindMazeGraphNode(maze_graph_t const *graph, point_t const *pos);
+
+/* Number of corridors leaving node `node`. */
+size_t MazeGraphNodeDegree(maze_graph_t const *graph, size_t node);
+/* Corridor `i` of node `node`.  Returns false if there is none. */
+bool_t GetMazeGraphEdge(
+  maze_graph_t const *graph, size_t node, size_t i, maze_graph_edge_t *edge);
+
+#endif /* _MAZE_GRAPH_H_ */
@@ -0,0 +1,890 @@
+/*
+ * Mazart - Hierarchical Maze Path Index
+ *  Module provides a tiled abstraction of a Maze which answers path
+ *  queries on huge Mazes by searching a small graph of tile entrances.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_hier.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "priority.h"
+#include "thread_pool.h"
+
+/* Mazes with fewer cells than this are indexed on the calling
+ * thread. */
+static size_t const kHierParallelCells = 65536;
+
+#define HIER_HEADER_SZ 64
+#define HIER_CHUNK_SZ 4096
+
+static uint8_t const kHierMagic[8] = {'M', 'Z', 'H', 'I', 'E', 'R', 0, 2};
+
+/* No entrance on that side. */
+#define HIER_NONE UINT32_MAX
+/* Not connected inside the tile. */
+#define HIER_FAR UINT16_MAX
+
+/* - - Hierarchical Index Structures - - */
+
+struct maze_hier_index_st {
+  maze_conn_t const *conns;
+  size_t height;
+  size_t width;
+  size_t tile_size;
+  size_t tile_rows;
+  size_t tile_cols;
+  size_t entrance_count;
+  size_t *first;          /* First entrance of each tile, plus the end. */
+  size_t *cells;          /* Cell of each entrance, ascending per tile. */
+  uint32_t *cross;        /* Entrance on the other side, per direction. */
+  size_t *edge_first;     /* First in-tile edge of each entrance. */
+  uint32_t *edge_nodes;   /* Entrance reachable inside the tile. */
+  uint16_t *edge_dists;   /* Steps to it. */
+  uint64_t maze_hash;     /* Hash of the Maze connections indexed. */
+  /* Query scratch, the entrances are followed by the two query cells. */
+  uint32_t stamp;
+  uint32_t *seen;
+  uint32_t *closed;
+  uint32_t *parents;
+  size_t *costs;
+  priority_queue_t *open;
+};
+
+/* Cells of one tile, and scratch for searching it. */
+typedef struct {
+  size_t tile;
+  size_t row;             /* First Maze row and column of the tile. */
+  size_t col;
+  size_t height;
+  size_t width;
+  uint16_t *dist;         /* Per tile cell. */
+  uint8_t *dirs;          /* Direction towards the search start. */
+  uint16_t *queue;
+} hier_tile_t;
+
+typedef struct {
+  maze_hier_index_t *index;
+  size_t tile_row;
+} hier_task_t;
+
+/* State of one query. */
+typedef struct {
+  size_t a;
+  size_t b;
+  hier_tile_t a_tile;
+  hier_tile_t b_tile;
+} hier_query_t;
+
+/* - - Hierarchical Index Internal API - - */
+
+static inline size_t HierTileOf(maze_hier_index_t const *index, size_t cell)
+{
+  return (cell / index->width / index->tile_size) * index->tile_cols
+    + (cell % index->width) / index->tile_size;
+}
+
+/* FNV-1a hash of the Maze connections, so an index file is only used
+ * for the Maze it was built for. */
+static uint64_t HashHierConnections(maze_conn_t const *conns, size_t count)
+{
+  uint64_t hash;
+  size_t i;
+  hash = 0xcbf29ce484222325ULL;
+  for (i = 0; i < count; i++)
+  {
+    hash ^= conns[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+static void AllocateHierTile(maze_hier_index_t const *index, hier_tile_t *tile)
+{
+  size_t cells;
+  memset(tile, 0, sizeof(hier_tile_t));
+  cells = index->tile_size * index->tile_size;
+  tile->dist = (uint16_t*)malloc(cells * sizeof(uint16_t));
+  tile->dirs = (uint8_t*)malloc(cells * sizeof(uint8_t));
+  tile->queue = (uint16_t*)malloc(cells * sizeof(uint16_t));
+}
+
+static void FreeHierTile(hier_tile_t *tile)
+{
+  free(tile->dist);
+  free(tile->dirs);
+  free(tile->queue);
+}
+
+static void SetHierTile(
+  maze_hier_index_t const *index, size_t tile_id, hier_tile_t *tile)
+{
+  tile->tile = tile_id;
+  tile->row = (tile_id / index->tile_cols) * index->tile_size;
+  tile->col = (tile_id % index->tile_cols) * index->tile_size;
+  tile->height = index->height - tile->row;
+  tile->width = index->width - tile->col;
+  if (tile->height > index->tile_size) tile->height = index->tile_size;
+  if (tile->width > index->tile_size) tile->width = index->tile_size;
+}
+
+/* Tile cell of a Maze cell inside the tile. */
+static inline size_t HierLocal(
+  maze_hier_index_t const *index, hier_tile_t const *tile, size_t cell)
+{
+  return (cell / index->width - tile->row) * tile->width
+    + (cell % index->width - tile->col);
+}
+
+static inline size_t HierGlobal(
+  maze_hier_index_t const *index, hier_tile_t const *tile, size_t local)
+{
+  return (tile->row + local / tile->width) * index->width
+    + tile->col + local % tile->width;
+}
+
+/* Connections of the tile cell `local` that leave the tile. */
+static inline maze_conn_t HierOutward(hier_tile_t const *tile, size_t local)
+{
+  size_t row, col;
+  maze_conn_t out;
+  row = local / tile->width;
+  col = local % tile->width;
+  out = 0;
+  if (row == 0) out |= MAZE_CONN_DOWN;
+  if (row == tile->height - 1) out |= MAZE_CONN_UP;
+  if (col == 0) out |= MAZE_CONN_LEFT;
+  if (col == tile->width - 1) out |= MAZE_CONN_RIGHT;
+  return out;
+}
+
+/* Breadth-first search from the Maze cell `start` without leaving the
+ * tile.  Fills the tile's distances and directions back to `start`. */
+static void SearchHierTile(
+  maze_hier_index_t const *index, hier_tile_t *tile, size_t start)
+{
+  size_t head, tail, u, v, d, cell;
+  maze_conn_t conns;
+  memset(tile->dist, 0xFF, tile->height * tile->width * sizeof(uint16_t));
+  u = HierLocal(index, tile, start);
+  tile->dist[u] = 0;
+  head = tail = 0;
+  tile->queue[tail++] = (uint16_t) u;
+  while (head < tail)
+  {
+    u = tile->queue[head++];
+    cell = HierGlobal(index, tile, u);
+    conns = index->conns[cell] & ~HierOutward(tile, u);
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      if (!(conns & MazeDirToConn(d))) continue;
+      v = HierLocal(index, tile, StepMazeIndex(cell, (maze_dir_t) d, index->width));
+      if (tile->dist[v] != HIER_FAR) continue;
+      tile->dist[v] = tile->dist[u] + 1;
+      tile->dirs[v] = (uint8_t) (d ^ 1);
+      tile->queue[tail++] = (uint16_t) v;
+    }
+  }
+}
+
+/* Visits the border cells of a tile, in row-major order, and returns
+ * the number of entrances.  Writes them to `cells` if not NULL. */
+static size_t FindHierEntrances(
+  maze_hier_index_t const *index, hier_tile_t const *tile, size_t *cells)
+{
+  size_t row, col, local, count;
+  count = 0;
+  for (row = 0; row < tile->height; row++)
+  for (col = 0; col < tile->width; col++)
+  {
+    /* Only the first and last column of inner rows. */
+    if (row > 0 && row < tile->height - 1 && col > 0 && col < tile->width - 1)
+      col = tile->width - 1;
+    local = row * tile->width + col;
+    if (!(index->conns[HierGlobal(index, tile, local)] & HierOutward(tile, local)))
+      continue;
+    if (cells) cells[count] = HierGlobal(index, tile, local);
+    count++;
+  }
+  return count;
+}
+
+static size_t FindHierEntrance(maze_hier_index_t const *index, size_t cell)
+{
+  size_t tile, lo, hi, mid;
+  tile = HierTileOf(index, cell);
+  lo = index->first[tile];
+  hi = index->first[tile + 1];
+  while (lo < hi)
+  {
+    mid = lo + (hi - lo) / 2;
+    if (index->cells[mid] < cell) lo = mid + 1;
+    else hi = mid;
+  }
+  if (lo < index->first[tile + 1] && index->cells[lo] == cell) return lo;
+  return HIER_NONE;
+}
+
+/* - - Index Building - - */
+
+static void CountHierTileRow(void *vtask)
+{
+  hier_task_t *task;
+  maze_hier_index_t *index;
+  hier_tile_t tile;
+  size_t t;
+  task = vtask;
+  index = task->index;
+  for (t = task->tile_row * index->tile_cols; t < (task->tile_row + 1) * index->tile_cols; t++)
+  {
+    SetHierTile(index, t, &tile);
+    index->first[t + 1] = FindHierEntrances(index, &tile, NULL);
+  }
+}
+
+/* Stores the row's entrances, and counts the in-tile edges of each.
+ * Entrances connected inside a tile form a group, and an entrance has
+ * an edge to every other entrance of its group, so one search per group
+ * is enough. */
+static void FillHierTileRow(void *vtask)
+{
+  hier_task_t *task;
+  maze_hier_index_t *index;
+  hier_tile_t tile;
+  size_t t, e, f, group;
+  uint8_t *grouped;
+  task = vtask;
+  index = task->index;
+  AllocateHierTile(index, &tile);
+  grouped = (uint8_t*)malloc(MAZE_DIR_COUNT * index->tile_size);
+  for (t = task->tile_row * index->tile_cols; t < (task->tile_row + 1) * index->tile_cols; t++)
+  {
+    SetHierTile(index, t, &tile);
+    FindHierEntrances(index, &tile, &index->cells[index->first[t]]);
+    memset(grouped, 0, index->first[t + 1] - index->first[t]);
+    for (e = index->first[t]; e < index->first[t + 1]; e++)
+    {
+      if (grouped[e - index->first[t]]) continue;
+      SearchHierTile(index, &tile, index->cells[e]);
+      group = 0;
+      for (f = e; f < index->first[t + 1]; f++)
+      {
+        if (tile.dist[HierLocal(index, &tile, index->cells[f])] != HIER_FAR) group++;
+      }
+      for (f = e; f < index->first[t + 1]; f++)
+      {
+        if (tile.dist[HierLocal(index, &tile, index->cells[f])] == HIER_FAR) continue;
+        grouped[f - index->first[t]] = 1;
+        index->edge_first[f + 1] = group - 1;
+      }
+    }
+  }
+  free(grouped);
+  FreeHierTile(&tile);
+}
+
+/* Links the entrances of the row's tiles across tile borders, and
+ * searches the tiles from each entrance.  Needs every tile's
+ * entrances. */
+static void LinkHierTileRow(void *vtask)
+{
+  hier_task_t *task;
+  maze_hier_index_t *index;
+  hier_tile_t tile;
+  size_t t, e, f, d, edge, cell;
+  maze_conn_t out;
+  uint16_t dist;
+  task = vtask;
+  index = task->index;
+  AllocateHierTile(index, &tile);
+  for (t = task->tile_row * index->tile_cols; t < (task->tile_row + 1) * index->tile_cols; t++)
+  {
+    SetHierTile(index, t, &tile);
+    for (e = index->first[t]; e < index->first[t + 1]; e++)
+    {
+      cell = index->cells[e];
+      out = index->conns[cell] & HierOutward(&tile, HierLocal(index, &tile, cell));
+      for (d = 0; d < MAZE_DIR_COUNT; d++)
+      {
+        index->cross[e * MAZE_DIR_COUNT + d] = (out & MazeDirToConn(d))
+          ? (uint32_t) FindHierEntrance(index,
+              StepMazeIndex(cell, (maze_dir_t) d, index->width))
+          : HIER_NONE;
+      }
+      SearchHierTile(index, &tile, cell);
+      edge = index->edge_first[e];
+      for (f = index->first[t]; f < index->first[t + 1]; f++)
+      {
+        dist = tile.dist[HierLocal(index, &tile, index->cells[f])];
+        if (f == e || dist == HIER_FAR) continue;
+        index->edge_nodes[edge] = (uint32_t) f;
+        index->edge_dists[edge] = dist;
+        edge++;
+      }
+    }
+  }
+  FreeHierTile(&tile);
+}
+
+static void RunHierTasks(
+  thread_pool_t *pool, hier_task_t *tasks, size_t task_count,
+  thread_task_t run)
+{
+  size_t i;
+  for (i = 0; i < task_count; i++)
+  {
+    if (!pool || !SubmitThreadTask(pool, run, &tasks[i])) run(&tasks[i]);
+  }
+  WaitThreadPool(pool);
+}
+
+static maze_hier_index_t *AllocateMazeHierIndex(
+  maze_t const *maze, size_t tile_size)
+{
+  maze_hier_index_t *index;
+  index = (maze_hier_index_t*)calloc(1, sizeof(maze_hier_index_t));
+  index->conns = GetMazeConnections(maze);
+  index->height = MazeHeight(maze);
+  index->width = MazeWidth(maze);
+  index->tile_size = tile_size;
+  index->tile_rows = (index->height + tile_size - 1) / tile_size;
+  index->tile_cols = (index->width + tile_size - 1) / tile_size;
+  index->first = (size_t*)calloc(
+    index->tile_rows * index->tile_cols + 1, sizeof(size_t));
+  return index;
+}
+
+/* Allocates the entrance arrays and query scratch, once the entrance
+ * count is known. */
+static void AllocateHierEntrances(maze_hier_index_t *index)
+{
+  size_t nodes;
+  nodes = index->entrance_count + 2;
+  index->cells = (size_t*)malloc(nodes * sizeof(size_t));
+  index->cross = (uint32_t*)malloc(
+    (index->entrance_count * MAZE_DIR_COUNT + 1) * sizeof(uint32_t));
+  index->edge_first = (size_t*)calloc(nodes, sizeof(size_t));
+  index->seen = (uint32_t*)calloc(nodes, sizeof(uint32_t));
+  index->closed = (uint32_t*)calloc(nodes, sizeof(uint32_t));
+  index->parents = (uint32_t*)malloc(nodes * sizeof(uint32_t));
+  index->costs = (size_t*)malloc(nodes * sizeof(size_t));
+  index->open = CreatePriorityQueue();
+}
+
+static void AllocateHierEdges(maze_hier_index_t *index)
+{
+  size_t edges;
+  edges = index->edge_first[index->entrance_count];
+  index->edge_nodes = (uint32_t*)malloc((edges + 1) * sizeof(uint32_t));
+  index->edge_dists = (uint16_t*)malloc((edges + 1) * sizeof(uint16_t));
+}
+
+/* - - Query Internal API - - */
+
+static inline size_t HierNodeCell(
+  maze_hier_index_t const *index, hier_query_t const *query, size_t node)
+{
+  if (node < index->entrance_count) return index->cells[node];
+  return node == index->entrance_count ? query->a : query->b;
+}
+
+static inline size_t HierHeuristic(
+  maze_hier_index_t const *index, size_t cell, size_t target)
+{
+  size_t r, c, tr, tc;
+  r = cell / index->width;
+  c = cell % index->width;
+  tr = target / index->width;
+  tc = target % index->width;
+  return (r > tr ? r - tr : tr - r) + (c > tc ? c - tc : tc - c);
+}
+
+static void RelaxHierNode(
+  maze_hier_index_t *index, hier_query_t const *query,
+  size_t node, size_t cost, size_t parent)
+{
+  if (index->closed[node] == index->stamp) return;
+  if (index->seen[node] == index->stamp && index->costs[node] <= cost) return;
+  index->seen[node] = index->stamp;
+  index->costs[node] = cost;
+  index->parents[node] = (uint32_t) parent;
+  EnqueuePriority(index->open,
+    SIZE_MAX - (cost + HierHeuristic(index, HierNodeCell(index, query, node), query->b)),
+    (void*) (uintptr_t) (node + 1));
+}
+
+/* Follows the abstract edges of `node`. */
+static void ExpandHierNode(
+  maze_hier_index_t *index, hier_query_t const *query, size_t node)
+{
+  hier_tile_t const *tile;
+  size_t node_a, node_b, t, i, f, d, cost;
+  uint16_t dist;
+  node_a = index->entrance_count;
+  node_b = node_a + 1;
+  cost = index->costs[node];
+  if (node == node_a)
+  {
+    tile = &query->a_tile;
+    for (f = index->first[tile->tile]; f < index->first[tile->tile + 1]; f++)
+    {
+      dist = tile->dist[HierLocal(index, tile, index->cells[f])];
+      if (dist != HIER_FAR) RelaxHierNode(index, query, f, cost + dist, node);
+    }
+    if (query->a_tile.tile == query->b_tile.tile)
+    {
+      dist = tile->dist[HierLocal(index, tile, query->b)];
+      if (dist != HIER_FAR) RelaxHierNode(index, query, node_b, cost + dist, node);
+    }
+    return;
+  }
+  for (i = index->edge_first[node]; i < index->edge_first[node + 1]; i++)
+  {
+    RelaxHierNode(index, query,
+      index->edge_nodes[i], cost + index->edge_dists[i], node);
+  }
+  for (d = 0; d < MAZE_DIR_COUNT; d++)
+  {
+    f = index->cross[node * MAZE_DIR_COUNT + d];
+    if (f != HIER_NONE) RelaxHierNode(index, query, f, cost + 1, node);
+  }
+  t = HierTileOf(index, index->cells[node]);
+  if (t == query->b_tile.tile)
+  {
+    dist = query->b_tile.dist[HierLocal(index, &query->b_tile, index->cells[node])];
+    if (dist != HIER_FAR) RelaxHierNode(index, query, node_b, cost + dist, node);
+  }
+}
+
+/* A* search of the abstract graph.  Returns the distance from `a` to
+ * `b`, or SIZE_MAX, and leaves the route in the parents. */
+static size_t SearchHierIndex(maze_hier_index_t *index, hier_query_t *query)
+{
+  size_t node, node_a, node_b;
+  void *item;
+  node_a = index->entrance_count;
+  node_b = node_a + 1;
+  /* Stamps save clearing the scratch for every query. */
+  if (++index->stamp == 0)
+  {
+    memset(index->seen, 0, (node_b + 1) * sizeof(uint32_t));
+    memset(index->closed, 0, (node_b + 1) * sizeof(uint32_t));
+    index->stamp = 1;
+  }
+  SetHierTile(index, HierTileOf(index, query->a), &query->a_tile);
+  SetHierTile(index, HierTileOf(index, query->b), &query->b_tile);
+  SearchHierTile(index, &query->a_tile, query->a);
+  SearchHierTile(index, &query->b_tile, query->b);
+  ClearPriorityQueue(index->open);
+  RelaxHierNode(index, query, node_a, 0, node_a);
+  while ((item = PopTopPriority(index->open)))
+  {
+    node = (size_t) (uintptr_t) item - 1;
+    if (index->closed[node] == index->stamp) continue;
+    index->closed[node] = index->stamp;
+    if (node == node_b) return index->costs[node_b];
+    ExpandHierNode(index, query, node);
+  }
+  return SIZE_MAX;
+}
+
+static bool_t StartHierQuery(
+  maze_hier_index_t *index, point_t const *a, point_t const *b,
+  hier_query_t *query)
+{
+  if (!index || !a || !b) return false;
+  if (a->row >= index->height || a->col >= index->width) return false;
+  if (b->row >= index->height || b->col >= index->width) return false;
+  query->a = a->row * index->width + a->col;
+  query->b = b->row * index->width + b->col;
+  AllocateHierTile(index, &query->a_tile);
+  AllocateHierTile(index, &query->b_tile);
+  return true;
+}
+
+/* Appends the steps from `from` to `to`, two cells of one tile or
+ * adjacent cells of neighbouring tiles. */
+static void RefineHierSegment(
+  maze_hier_index_t const *index, hier_tile_t *tile,
+  size_t from, size_t to, maze_path_t *path)
+{
+  size_t local;
+  maze_dir_t dir;
+  if (HierTileOf(index, from) != HierTileOf(index, to))
+  {
+    if (to == from + index->width) PushMazePathStep(path, MAZE_DIR_UP);
+    else if (to + index->width == from) PushMazePathStep(path, MAZE_DIR_DOWN);
+    else if (to == from + 1) PushMazePathStep(path, MAZE_DIR_RIGHT);
+    else PushMazePathStep(path, MAZE_DIR_LEFT);
+    return;
+  }
+  /* Searching back from `to` gives the directions in walking order. */
+  SetHierTile(index, HierTileOf(index, to), tile);
+  SearchHierTile(index, tile, to);
+  for (local = HierLocal(index, tile, from); from != to; )
+  {
+    dir = (maze_dir_t) tile->dirs[local];
+    PushMazePathStep(path, dir);
+    from = StepMazeIndex(from, dir, index->width);
+    local = HierLocal(index, tile, from);
+  }
+}
+
+/* - - Hierarchical Maze Path Index API - - */
+
+maze_hier_index_t *CreateMazeHierIndex(maze_t const *maze, size_t tile_size)
+{
+  maze_hier_index_t *index;
+  hier_task_t *tasks;
+  thread_pool_t *pool;
+  size_t tile_count, t, e;
+  if (!maze || tile_size == 0 || tile_size > MAZE_HIER_TILE_SIZE_MAX) return NULL;
+  if (MazeHeight(maze) == 0 || MazeWidth(maze) == 0) return NULL;
+  index = AllocateMazeHierIndex(maze, tile_size);
+  tile_count = index->tile_rows * index->tile_cols;
+  tasks = (hier_task_t*)calloc(index->tile_rows, sizeof(hier_task_t));
+  for (t = 0; t < index->tile_rows; t++)
+  {
+    tasks[t].index = index;
+    tasks[t].tile_row = t;
+  }
+  pool = NULL;
+  if (index->height * index->width >= kHierParallelCells) pool = CreateThreadPool(0);
+
+  RunHierTasks(pool, tasks, index->tile_rows, CountHierTileRow);
+  for (t = 0; t < tile_count; t++) index->first[t + 1] += index->first[t];
+  index->entrance_count = index->first[tile_count];
+  /* Entrances and the two query cells are numbered in 32 bits. */
+  if (index->entrance_count >= HIER_NONE - 2)
+  {
+    FreeThreadPool(pool);
+    free(tasks);
+    FreeMazeHierIndex(index);
+    return NULL;
+  }
+  AllocateHierEntrances(index);
+  RunHierTasks(pool, tasks, index->tile_rows, FillHierTileRow);
+  for (e = 0; e < index->entrance_count; e++)
+  {
+    index->edge_first[e + 1] += index->edge_first[e];
+  }
+  AllocateHierEdges(index);
+  RunHierTasks(pool, tasks, index->tile_rows, LinkHierTileRow);
+  index->maze_hash = HashHierConnections(index->conns, index->height * index->width);
+
+  FreeThreadPool(pool);
+  free(tasks);
+  return index;
+}
+
+void FreeMazeHierIndex(maze_hier_index_t *index)
+{
+  if (!index) return;
+  free(index->first);
+  free(index->cells);
+  free(index->cross);
+  free(index->edge_first);
+  free(index->edge_nodes);
+  free(index->edge_dists);
+  free(index->seen);
+  free(index->closed);
+  free(index->parents);
+  free(index->costs);
+  FreePriorityQueue(index->open);
+  memset(index, 0, sizeof(maze_hier_index_t));
+  free(index);
+}
+
+size_t MazeHierIndexTileSize(maze_hier_index_t const *index)
+{
+  if (!index) return 0;
+  return index->tile_size;
+}
+
+size_t MazeHierIndexEntranceCount(maze_hier_index_t const *index)
+{
+  if (!index) return 0;
+  return index->entrance_count;
+}
+
+size_t MazeHierIndexDistance(
+  maze_hier_index_t *index, point_t const *a, point_t const *b)
+{
+  hier_query_t query;
+  size_t distance;
+  if (!StartHierQuery(index, a, b, &query)) return SIZE_MAX;
+  distance = SearchHierIndex(index, &query);
+  FreeHierTile(&query.a_tile);
+  FreeHierTile(&query.b_tile);
+  return distance;
+}
+
+maze_path_t *GetMazeHierIndexPath(
+  maze_hier_index_t *index, point_t const *a, point_t const *b)
+{
+  hier_query_t query;
+  maze_path_t *path;
+  size_t *route, count, node, node_a, i;
+  if (!StartHierQuery(index, a, b, &query)) return NULL;
+  path = NULL;
+  node_a = index->entrance_count;
+  if (SearchHierIndex(index, &query) != SIZE_MAX)
+  {
+    /* The route of abstract nodes, from `b` back to `a`. */
+    count = 1;
+    for (node = node_a + 1; node != node_a; node = index->parents[node]) count++;
+    route = (size_t*)malloc(count * sizeof(size_t));
+    i = count;
+    for (node = node_a + 1; ; node = index->parents[node])
+    {
+      route[--i] = HierNodeCell(index, &query, node);
+      if (node == node_a) break;
+    }
+    path = CreateMazePath(a);
+    for (i = 1; i < count; i++)
+    {
+      RefineHierSegment(index, &query.a_tile, route[i - 1], route[i], path);
+    }
+    free(route);
+  }
+  FreeHierTile(&query.a_tile);
+  FreeHierTile(&query.b_tile);
+  return path;
+}
+
+size_t AnswerMazeHierQueries(
+  maze_hier_index_t *index, FILE *queries, FILE *answers)
+{
+  char line[256];
+  unsigned long a_row, a_col, b_row, b_col;
+  point_t a, b;
+  size_t count, distance;
+  if (!index || !queries || !answers) return 0;
+  count = 0;
+  while (fgets(line, sizeof(line), queries))
+  {
+    if (sscanf(line, "%lu %lu %lu %lu", &a_row, &a_col, &b_row, &b_col) != 4)
+      continue;
+    a = (point_t) {.row = a_row, .col = a_col};
+    b = (point_t) {.row = b_row, .col = b_col};
+    distance = MazeHierIndexDistance(index, &a, &b);
+    if (distance == SIZE_MAX)
+      fprintf(answers, "%lu %lu %lu %lu -1\n", a_row, a_col, b_row, b_col);
+    else
+      fprintf(answers, "%lu %lu %lu %lu %lu\n", a_row, a_col, b_row, b_col, distance);
+    count++;
+  }
+  return count;
+}
+
+/* - - Index Files Internal API - - */
+
+static void EncodeHierWord(uint8_t *buf, uint64_t value)
+{
+  size_t i;
+  for (i = 0; i < 8; i++) buf[i] = (uint8_t) (value >> (8 * i));
+}
+
+static uint64_t DecodeHierWord(uint8_t const *buf)
+{
+  uint64_t value;
+  size_t i;
+  value = 0;
+  for (i = 0; i < 8; i++) value |= ((uint64_t) buf[i]) << (8 * i);
+  return value;
+}
+
+static uint64_t GetHierValue(void const *values, size_t i, size_t size)
+{
+  switch (size)
+  {
+    case sizeof(uint16_t): return ((uint16_t const*) values)[i];
+    case sizeof(uint32_t): return ((uint32_t const*) values)[i];
+    default: return ((size_t const*) values)[i];
+  }
+}
+
+static void SetHierValue(void *values, size_t i, size_t size, uint64_t value)
+{
+  switch (size)
+  {
+    case sizeof(uint16_t): ((uint16_t*) values)[i] = (uint16_t) value; break;
+    case sizeof(uint32_t): ((uint32_t*) values)[i] = (uint32_t) value; break;
+    default: ((size_t*) values)[i] = (size_t) value; break;
+  }
+}
+
+/* Writes `count` values of `size` bytes as little-endian values. */
+static bool_t WriteHierValues(
+  FILE *fp, void const *values, size_t count, size_t size)
+{
+  uint8_t chunk[HIER_CHUNK_SZ];
+  uint8_t word[8];
+  size_t i, n;
+  n = 0;
+  for (i = 0; i < count; i++)
+  {
+    EncodeHierWord(word, GetHierValue(values, i, size));
+    memcpy(&chunk[n], word, size);
+    n += size;
+    if (n + 8 > sizeof(chunk))
+    {
+      if (fwrite(chunk, 1, n, fp) != n) return false;
+      n = 0;
+    }
+  }
+  return n == 0 || fwrite(chunk, 1, n, fp) == n;
+}
+
+static bool_t ReadHierValues(FILE *fp, void *values, size_t count, size_t size)
+{
+  uint8_t chunk[HIER_CHUNK_SZ];
+  uint8_t word[8];
+  size_t i, j, n;
+  memset(word, 0, sizeof(word));
+  for (i = 0; i < count; i += n)
+  {
+    n = (count - i < sizeof(chunk) / size) ? count - i : sizeof(chunk) / size;
+    if (fread(chunk, size, n, fp) != n) return false;
+    for (j = 0; j < n; j++)
+    {
+      memcpy(word, &chunk[j * size], size);
+      SetHierValue(values, i + j, size, DecodeHierWord(word));
+    }
+  }
+  return true;
+}
+
+/* Checks an index read from a file, so queries can trust it. */
+static bool_t IsHierIndexValid(maze_hier_index_t const *index)
+{
+  size_t tile_count, t, e, d, i;
+  uint32_t node;
+  tile_count = index->tile_rows * index->tile_cols;
+  if (index->first[0] != 0 || index->edge_first[0] != 0) return false;
+  for (t = 0; t < tile_count; t++)
+  {
+    if (index->first[t + 1] < index->first[t]) return false;
+    for (e = index->first[t]; e < index->first[t + 1]; e++)
+    {
+      if (index->cells[e] >= index->height * index->width) return false;
+      if (HierTileOf(index, index->cells[e]) != t) return false;
+      if (e > index->first[t] && index->cells[e] <= index->cells[e - 1]) return false;
+      for (d = 0; d < MAZE_DIR_COUNT; d++)
+      {
+        node = index->cross[e * MAZE_DIR_COUNT + d];
+        if (node != HIER_NONE && node >= index->entrance_count) return false;
+      }
+      if (index->edge_first[e + 1] < index->edge_first[e]) return false;
+      for (i = index->edge_first[e]; i < index->edge_first[e + 1]; i++)
+      {
+        if (index->edge_nodes[i] < index->first[t]) return false;
+        if (index->edge_nodes[i] >= index->first[t + 1]) return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* - - Index Files - - */
+
+bool_t WriteMazeHierIndexFile(
+  maze_hier_index_t const *index, char const *filename)
+{
+  FILE *fp;
+  uint8_t header[HIER_HEADER_SZ];
+  size_t tile_count, edge_count;
+  bool_t ok;
+  if (!index || !filename) return false;
+  fp = fopen(filename, "wb");
+  if (!fp) return false;
+  tile_count = index->tile_rows * index->tile_cols;
+  edge_count = index->edge_first[index->entrance_count];
+  memset(header, 0, sizeof(header));
+  memcpy(header, kHierMagic, sizeof(kHierMagic));
+  EncodeHierWord(&header[8], index->height);
+  EncodeHierWord(&header[16], index->width);
+  EncodeHierWord(&header[24], index->tile_size);
+  EncodeHierWord(&header[32], index->entrance_count);
+  EncodeHierWord(&header[40], edge_count);
+  EncodeHierWord(&header[48], index->maze_hash);
+  ok = fwrite(header, 1, sizeof(header), fp) == sizeof(header)
+    && WriteHierValues(fp, index->first, tile_count + 1, sizeof(size_t))
+    && WriteHierValues(fp, index->cells, index->entrance_count, sizeof(size_t))
+    && WriteHierValues(fp, index->cross,
+        index->entrance_count * MAZE_DIR_COUNT, sizeof(uint32_t))
+    && WriteHierValues(fp, index->edge_first,
+        index->entrance_count + 1, sizeof(size_t))
+    && WriteHierValues(fp, index->edge_nodes, edge_count, sizeof(uint32_t))
+    && WriteHierValues(fp, index->edge_dists, edge_count, sizeof(uint16_t));
+  if (fclose(fp) != 0) ok = false;
+  return ok;
+}
+
+maze_hier_index_t *ReadMazeHierIndexFile(
+  maze_t const *maze, size_t tile_size, char const *filename)
+{
+  FILE *fp;
+  uint8_t header[HIER_HEADER_SZ];
+  maze_hier_index_t *index;
+  size_t tile_count, edge_count;
+  uint64_t maze_hash;
+  bool_t ok;
+  if (!maze || !filename) return NULL;
+  if (tile_size == 0 || tile_size > MAZE_HIER_TILE_SIZE_MAX) return NULL;
+  fp = fopen(filename, "rb");
+  if (!fp) return NULL;
+  if (fread(header, 1, sizeof(header), fp) != sizeof(header)
+      || memcmp(header, kHierMagic, sizeof(kHierMagic)) != 0
+      || DecodeHierWord(&header[8]) != MazeHeight(maze)
+      || DecodeHierWord(&header[16]) != MazeWidth(maze)
+      || DecodeHierWord(&header[24]) != tile_size
+      || DecodeHierWord(&header[32]) >= HIER_NONE - 2)
+  {
+    fclose(fp);
+    return NULL;
+  }
+  maze_hash = HashHierConnections(GetMazeConnections(maze),
+    MazeHeight(maze) * MazeWidth(maze));
+  if (DecodeHierWord(&header[48]) != maze_hash)
+  {
+    fclose(fp);
+    return NULL;
+  }
+  index = AllocateMazeHierIndex(maze, tile_size);
+  index->maze_hash = maze_hash;
+  tile_count = index->tile_rows * index->tile_cols;
+  /* The counts in the header size the arrays. */
+  ok = ReadHierValues(fp, index->first, tile_count + 1, sizeof(size_t))
+    && index->first[tile_count] == DecodeHierWord(&header[32]);
+  edge_count = (size_t) DecodeHierWord(&header[40]);
+  if (ok)
+  {
+    index->entrance_count = index->first[tile_count];
+    AllocateHierEntrances(index);
+    ok = ReadHierValues(fp, index->cells, index->entrance_count, sizeof(size_t))
+      && ReadHierValues(fp, index->cross,
+          index->entrance_count * MAZE_DIR_COUNT, sizeof(uint32_t))
+      && ReadHierValues(fp, index->edge_first,
+          index->entrance_count + 1, sizeof(size_t))
+      && index->edge_first[index->entrance_count] == edge_count;
+  }
+  if (ok)
+  {
+    AllocateHierEdges(index);
+    ok = ReadHierValues(fp, index->edge_nodes, edge_count, sizeof(uint32_t))
+      && ReadHierValues(fp, index->edge_dists, edge_count, sizeof(uint16_t))
+      && IsHierIndexValid(index);
+  }
+  fclose(fp);
+  if (!ok)
+  {
+    FreeMazeHierIndex(index);
+    return NULL;
+  }
+  return index;
+}
@@ -0,0 +1,83 @@
+/*
+ * Mazart - Hierarchical Maze Path Index
+ *  Module provides a tiled abstraction of a Maze which answers path
+ *  queries on huge Mazes by searching a small graph of tile entrances.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_HIER_H_
+#define _MAZE_HIER_H_
+
+#include <stdio.h>
+
+#include "common.h"
+#include "maze.h"
+#include "maze_path.h"
+
+/* Largest tile side, so in-tile distances fit in 16 bits. */
+#define MAZE_HIER_TILE_SIZE_MAX 255
+
+/*
+ * Hierarchical Maze Path Index
+ *  The Maze is split into square tiles.  An entrance is a cell with a
+ *  connection to another tile, and the index stores the entrances of
+ *  each tile, with an edge to every other entrance of the tile that can
+ *  be reached without leaving it and the number of steps to it.  Tiles
+ *  are indexed in parallel.
+ *
+ *  A query is an A* search of the abstract graph of entrances, with
+ *  the two query cells joined to the entrances of their own tiles.
+ *  Only the tiles on the found route are searched cell by cell, and
+ *  only when the path itself is asked for.  Unlike the Maze Path Index
+ *  (see maze_index.h), Mazes with loops are supported.
+ *
+ *  The index keeps a pointer to the Maze, which must outlive it and
+ *  must not change.  Queries reuse scratch memory in the index, so one
+ *  index must not be queried from several threads at once.
+ *
+ *  An index file is a 64 byte header (magic, Maze height and width,
+ *  tile size, entrance and edge counts, and a hash of the Maze
+ *  connections, as little-endian 64-bit values) followed by the index
+ *  arrays, so an index can be stored next to the Maze it was built
+ *  for.  A file of another Maze is detected by its hash.
+ */
+typedef struct maze_hier_index_st maze_hier_index_t;
+
+/* - - Hierarchical Maze Path Index API - - */
+
+/* Indexes `maze` with tiles of `tile_size` x `tile_size` cells.
+ * Returns NULL if the tile size is 0 or too large, or if the Maze has
+ * too many entrances. */
+maze_hier_index_t *CreateMazeHierIndex(maze_t const *maze, size_t tile_size);
+void FreeMazeHierIndex(maze_hier_index_t *index);
+
+size_t MazeHierIndexTileSize(maze_hier_index_t const *index);
+size_t MazeHierIndexEntranceCount(maze_hier_index_t const *index);
+
+/* Number of steps on the shortest path between `a` and `b`.  Returns
+ * SIZE_MAX if either cell is outside the Maze or there is no path. */
+size_t MazeHierIndexDistance(
+  maze_hier_index_t *index, point_t const *a, point_t const *b);
+/* Shortest path from `a` to `b`.  Returns NULL if there is none. */
+maze_path_t *GetMazeHierIndexPath(
+  maze_hier_index_t *index, point_t const *a, point_t const *b);
+
+/* Answers a batch of queries, in the same format as
+ * AnswerMazePathQueries().  Returns the number of queries answered. */
+size_t AnswerMazeHierQueries(
+  maze_hier_index_t *index, FILE *queries, FILE *answers);
+
+/* - - Index Files - - */
+
+/* Returns false if the file cannot be written. */
+bool_t WriteMazeHierIndexFile(
+  maze_hier_index_t const *index, char const *filename);
+/* Reads an index of `maze` with tiles of `tile_size` cells.  Returns
+ * NULL if the file cannot be read, or was not built for the same Maze
+ * connections and tile size. */
+maze_hier_index_t *ReadMazeHierIndexFile(
+  maze_t const *maze, size_t tile_size, char const *filename);
+
+#endif /* _MAZE_HIER_H_ */
@@ -0,0 +1,161 @@
+/*
+ * Mazart - Hunt-and-Kill Maze Generator
+ *  Module provides a hunt-and-kill Maze generator, which needs no
+ *  frontier queue or stack.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_hunt.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* - - Hunt-and-Kill Generator Structure - - */
+
+struct hunt_gen_st {
+  maze_t *maze;
+  maze_conn_t *conns;
+  size_t height;
+  size_t width;
+  size_t start;        /* Index of the start cell. */
+  size_t cursor;       /* Rows before the cursor are fully visited. */
+  uint64_t *row_open;  /* Bit per row, set if the row has unvisited cells. */
+  point_t pos;         /* Head of the current walk. */
+  bool_t done;
+};
+
+/* - - Hunt-and-Kill Internal API - - */
+
+static inline bool_t IsHuntCellVisited(hunt_gen_t const *hunt, point_t const *pos)
+{
+  size_t idx;
+  idx = pos->row * hunt->width + pos->col;
+  return hunt->conns[idx] || idx == hunt->start;
+}
+
+/* Directions from `pos` to neighbours whose visited state is
+ * `visited`.  Returns the number of directions found. */
+static size_t FindHuntNeighbours(
+  hunt_gen_t const *hunt, point_t const *pos, bool_t visited,
+  maze_dir_t *dirs)
+{
+  point_t next;
+  size_t n, d;
+  n = 0;
+  for (d = 0; d < MAZE_DIR_COUNT; d++)
+  {
+    next = *pos;
+    if (!StepMazePoint(&next, (maze_dir_t) d, hunt->height, hunt->width)) continue;
+    if (IsHuntCellVisited(hunt, &next) != visited) continue;
+    dirs[n++] = (maze_dir_t) d;
+  }
+  return n;
+}
+
+/* Connects `pos` to its neighbour in `dir` and moves `pos` there. */
+static void CarveHuntPassage(hunt_gen_t *hunt, point_t *pos, maze_dir_t dir)
+{
+  size_t idx;
+  idx = pos->row * hunt->width + pos->col;
+  StepMazePoint(pos, dir, hunt->height, hunt->width);
+  hunt->conns[idx] |= MazeDirToConn(dir);
+  hunt->conns[pos->row * hunt->width + pos->col] |=
+    MazeDirToConn(OppositeMazeDir(dir));
+}
+
+/* Finds an unvisited cell next to a visited one, connects it to a
+ * random visited neighbour and stores it in `pos`.  Returns false once
+ * every cell is visited. */
+static bool_t HuntForCell(hunt_gen_t *hunt, point_t *pos)
+{
+  maze_dir_t dirs[MAZE_DIR_COUNT];
+  point_t cell;
+  size_t n;
+  bool_t row_open;
+  for (cell.row = hunt->cursor; cell.row < hunt->height; cell.row++)
+  {
+    if (!(hunt->row_open[cell.row / 64] & (UINT64_C(1) << (cell.row % 64))))
+      continue;
+    row_open = false;
+    for (cell.col = 0; cell.col < hunt->width; cell.col++)
+    {
+      if (IsHuntCellVisited(hunt, &cell)) continue;
+      row_open = true;
+      n = FindHuntNeighbours(hunt, &cell, true, dirs);
+      if (n == 0) continue;
+      *pos = cell;
+      CarveHuntPassage(hunt, &cell, dirs[NextMazeRandom(hunt->maze) % n]);
+      return true;
+    }
+    if (row_open) continue;
+    hunt->row_open[cell.row / 64] &= ~(UINT64_C(1) << (cell.row % 64));
+    if (cell.row == hunt->cursor) hunt->cursor++;
+  }
+  return false;
+}
+
+/* - - Hunt-and-Kill API - - */
+
+hunt_gen_t *CreateHuntGenerator(maze_t *maze)
+{
+  hunt_gen_t *hunt;
+  size_t words, i;
+  if (!maze) return NULL;
+  hunt = (hunt_gen_t*)calloc(1, sizeof(hunt_gen_t));
+  hunt->maze = maze;
+  hunt->conns = GetMazeConnectionsMutable(maze);
+  hunt->height = MazeHeight(maze);
+  hunt->width = MazeWidth(maze);
+  hunt->cursor = 0;
+  words = (hunt->height + 63) / 64;
+  hunt->row_open = (uint64_t*)calloc(words, sizeof(uint64_t));
+  for (i = 0; i < words; i++) hunt->row_open[i] = ~UINT64_C(0);
+  MazeStart(maze, &hunt->pos);
+  hunt->start = hunt->pos.row * hunt->width + hunt->pos.col;
+  return hunt;
+}
+
+void FreeHuntGenerator(hunt_gen_t *hunt)
+{
+  if (!hunt) return;
+  free(hunt->row_open);
+  memset(hunt, 0, sizeof(hunt_gen_t));
+  free(hunt);
+}
+
+size_t StepHuntGenerator(hunt_gen_t *hunt, size_t max_edges)
+{
+  maze_dir_t dirs[MAZE_DIR_COUNT];
+  size_t edges, n;
+  if (!hunt) return 0;
+  edges = 0;
+  while (!hunt->done && edges < max_edges)
+  {
+    /* Kill: random walk through unvisited cells until stuck. */
+    n = FindHuntNeighbours(hunt, &hunt->pos, false, dirs);
+    if (n > 0)
+    {
+      CarveHuntPassage(hunt, &hunt->pos, dirs[NextMazeRandom(hunt->maze) % n]);
+      edges++;
+    }
+    else if (HuntForCell(hunt, &hunt->pos)) edges++;
+    else hunt->done = true;
+  }
+  return edges;
+}
+
+bool_t IsHuntGeneratorDone(hunt_gen_t const *hunt)
+{
+  if (!hunt) return true;
+  return hunt->done;
+}
+
+void DrawHuntAndKillMaze(maze_t *maze)
+{
+  hunt_gen_t *hunt;
+  hunt = CreateHuntGenerator(maze);
+  StepHuntGenerator(hunt, SIZE_MAX);
+  FreeHuntGenerator(hunt);
+}
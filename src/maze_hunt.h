@@ -0,0 +1,40 @@
+/*
+ * Mazart - Hunt-and-Kill Maze Generator
+ *  Module provides a hunt-and-kill Maze generator, which needs no
+ *  frontier queue or stack.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_HUNT_H_
+#define _MAZE_HUNT_H_
+
+#include "common.h"
+#include "maze.h"
+
+/* Draws the Maze's connections with random walks ("kill") from the
+ * Maze start.  When a walk gets stuck, rows are scanned ("hunt") for an
+ * unvisited cell next to a visited one, and a new walk starts there.
+ * Extra memory is a row-scan cursor and one "has unvisited" bit per
+ * row, a cell counts as visited once it has a connection.  The Maze
+ * connections are expected to be cleared. */
+void DrawHuntAndKillMaze(maze_t *maze);
+
+/*
+ * Hunt-and-Kill Generator
+ *  Resumable form of DrawHuntAndKillMaze(), the walk head and row-scan
+ *  cursor are kept between steps.  The Maze must outlive the generator,
+ *  and its connections are expected to be cleared before the first
+ *  step.
+ */
+typedef struct hunt_gen_st hunt_gen_t;
+
+hunt_gen_t *CreateHuntGenerator(maze_t *maze);
+/* Frees the generator, the Maze is left as drawn so far. */
+void FreeHuntGenerator(hunt_gen_t *hunt);
+/* Draws at most `max_edges` connections.  Returns the number drawn. */
+size_t StepHuntGenerator(hunt_gen_t *hunt, size_t max_edges);
+bool_t IsHuntGeneratorDone(hunt_gen_t const *hunt);
+
+#endif /* _MAZE_HUNT_H_ */
@@ -104,6 +104,10 @@ struct maze_image_st {
 
 static void DrawMazeImageBorders(maze_image_t *image);
 static void DrawMazeImageCells(maze_image_t *image, maze_t const *maze);
+/* Draws the space between a Maze Cell and its neighbour in `dir`. */
+static void DrawMazeImageGap(
+  maze_image_t *image, maze_t const *maze,
+  point_t const *mpos, maze_dir_t dir);
 /* Fills all image cells that are NULL. */
 static void FillEmptyMazeImageCells(maze_image_t *image, rgb_t const *color);
 /* Draws a solid rectangle. */
@@ -152,6 +156,12 @@ static inline void GetConnColor(
  * or left-right). */
 static bool_t PositionsAreAdjacent(point_t const *a, point_t const *b);
 
+/* Fills the path cell at `pos`, and its connection to `prev` if that is
+ * an adjacent cell. */
+static void DrawPathCellOnMazeImage(
+  maze_image_t *image, point_t const *pos, point_t const *prev,
+  rgb_t const *color);
+
 /* - - Maze Image API - - */
 
 maze_image_t *CreateMazeImage(
@@ -213,66 +223,100 @@ void DrawPathOnMazeImage(
   point_t const *path, size_t path_length,
   rgb_t const *color)
 {
-  point_t ipos;
   size_t i;
   if (!image || !path) return;
   /* Use default path color if no color is provided.  */
   if (!color) color = &image->config.default_path_color;
   for (i = 0; i < path_length; i++)
   {
-    /* Fill cell. */
-    MazePositionToMazeImagePosition(image, &path[i], &ipos);
+    DrawPathCellOnMazeImage(image, &path[i], i > 0 ? &path[i - 1] : NULL, color);
+  }
+}
+
+void DrawMazePathOnMazeImage(
+  maze_image_t *image, maze_path_t const *path, rgb_t const *color)
+{
+  maze_path_iter_t iter;
+  point_t prev;
+  if (!image || !path) return;
+  if (!color) color = &image->config.default_path_color;
+  StartMazePathIter(&iter, path);
+  while (NextMazePathIter(&iter))
+  {
+    DrawPathCellOnMazeImage(image, &iter.pos, iter.index > 1 ? &prev : NULL, color);
+    prev = iter.pos;
+  }
+}
+
+void RedrawMazeImageCells(
+  maze_image_t *image, maze_t const *maze,
+  point_t const *cells, size_t cell_count)
+{
+  point_t ipos;
+  rgb_t color;
+  maze_cell_t *cell;
+  size_t i, d;
+  if (!image || !maze || !cells) return;
+  for (i = 0; i < cell_count; i++)
+  {
+    cell = GetMazeCell(maze, &cells[i]);
+    if (!cell) continue;
+    GetCellColor(image, cell, &color);
+    MazePositionToMazeImagePosition(image, &cells[i], &ipos);
     DrawRectangleOnMazeImage(
       image, &ipos,
       image->config.cell_width, image->config.cell_width,
-      color);
-    /* Fill connection. */
-    if (i > 0 && image->config.wall_width > 0)
+      &color);
+    if (image->config.wall_width == 0) continue;
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
     {
-      /* Can only fill connections of consecutive points are adjacent. */
-      if (!PositionsAreAdjacent(&path[i], &path[i - 1])) continue;
-
-      /* DrawRectangle: h, w */
-      if (path[i].row < path[i - 1].row)
-      {
-        /* Case: Current cell is a row below */
-        ipos.row += image->config.cell_width;
-        DrawRectangleOnMazeImage(
-          image, &ipos,
-          image->config.wall_width, image->config.cell_width,
-          color);
-      }
-      else if (path[i].row > path[i - 1].row)
-      {
-        /* Case: Current cell is a row above */
-        ipos.row -= image->config.wall_width;
-        DrawRectangleOnMazeImage(
-          image, &ipos,
-          image->config.wall_width, image->config.cell_width,
-          color);
-      }
-      else if (path[i].col < path[i - 1].col)
-      {
-        /* Case: Current cell is a column below */
-        ipos.col += image->config.cell_width;
-        DrawRectangleOnMazeImage(
-          image, &ipos,
-          image->config.cell_width, image->config.wall_width,
-          color);
-      }
-      else
-      {
-        /* Case: Current cell is a column above */
-        ipos.col -= image->config.wall_width;
-        DrawRectangleOnMazeImage(
-          image, &ipos,
-          image->config.cell_width, image->config.wall_width,
-          color);
-      }
+      DrawMazeImageGap(image, maze, &cells[i], (maze_dir_t) d);
     }
   }
 }
 
+void OpenMazeImageBorder(
+  maze_image_t *image, maze_t const *maze,
+  point_t const *mpos, maze_dir_t dir)
+{
+  point_t ipos, npos;
+  rgb_t color;
+  maze_cell_t *cell;
+  size_t height, width;
+  if (!image || !maze || !mpos) return;
+  if (image->config.border_width == 0) return;
+  cell = GetMazeCell(maze, mpos);
+  if (!cell) return;
+  /* Only cells on the side facing `dir` touch the border. */
+  npos = *mpos;
+  if (StepMazePoint(&npos, dir, MazeHeight(maze), MazeWidth(maze))) return;
+  GetConnColor(image, cell, cell, &color);
+  MazePositionToMazeImagePosition(image, mpos, &ipos);
+  height = image->config.cell_width;
+  width = image->config.cell_width;
+  switch (dir)
+  {
+    case MAZE_DIR_UP:
+      ipos.row += image->config.cell_width;
+      height = image->config.border_width;
+      break;
+    case MAZE_DIR_DOWN:
+      ipos.row -= image->config.border_width;
+      height = image->config.border_width;
+      break;
+    case MAZE_DIR_LEFT:
+      ipos.col -= image->config.border_width;
+      width = image->config.border_width;
+      break;
+    case MAZE_DIR_RIGHT:
+    default:
+      ipos.col += image->config.cell_width;
+      width = image->config.border_width;
+      break;
+  }
+  DrawRectangleOnMazeImage(image, &ipos, height, width, &color);
+}
+
 #ifndef _NO_PNG
 #define BIT_DEPTH 8
 static size_t const kOneKiloByte = 1024;
@@ -433,6 +477,154 @@ CLEAN_UP_END:
   }
 }
 
+/* Fills `count` pixels of a PNG row, starting at pixel `col`. */
+static void FillPNGRowSpan(
+  png_byte *row_data, size_t col, size_t count, rgb_t const *color)
+{
+  size_t i;
+  for (i = col; i < col + count; i++)
+  {
+    row_data[i * 3] = color->red;
+    row_data[i * 3 + 1] = color->green;
+    row_data[i * 3 + 2] = color->blue;
+  }
+}
+
+void ExportMazeFileToPNG(
+  maze_file_t *file, maze_image_config_t const *config, char const *png_path)
+{
+  FILE *out_fp;
+  png_structp png_ptr;
+  png_infop info_ptr;
+  bool_t exit_on_cleanup;  /* Do not rename, needed n EXPORT_EXIT macro. */
+  maze_image_config_t img_config;
+  png_byte *cell_row, *wall_row, *border_row;
+  maze_conn_t *row_conns;
+  size_t mheight, mwidth, width, height, col, px, row, i;
+  if (!file || !png_path || (config && !IsConfigValid(config)))
+  {
+    fprintf(stderr, "Missing maze file, png_path or valid config\n");
+    exit(EXIT_FAILURE);
+  }
+  if (config) CopyConfig(config, &img_config);
+  else DefaultMazeImageConfig(&img_config);
+
+  png_ptr = NULL;
+  info_ptr = NULL;
+  exit_on_cleanup = false;
+  mheight = MazeFileHeight(file);
+  mwidth = MazeFileWidth(file);
+  width = (mwidth * img_config.cell_width)
+    + ((mwidth - 1) * img_config.wall_width)
+    + (img_config.border_width * 2);
+  height = (mheight * img_config.cell_width)
+    + ((mheight - 1) * img_config.wall_width)
+    + (img_config.border_width * 2);
+  /* Only one maze row and three pixel rows are ever held. */
+  row_conns = (maze_conn_t*)calloc(mwidth, sizeof(maze_conn_t));
+  cell_row = (png_byte*)malloc(width * 3);
+  wall_row = (png_byte*)malloc(width * 3);
+  border_row = (png_byte*)malloc(width * 3);
+  FillPNGRowSpan(border_row, 0, width, &img_config.border_color);
+
+  out_fp = fopen(png_path, "wb");
+  if (!out_fp)
+  {
+    fprintf(stderr, "Failed to open PNG export file %s\n", png_path);
+    EXPORT_EXIT(CLEAN_UP_ROW_DATA);
+  }
+
+  png_ptr = png_create_write_struct(
+    PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+  if (!png_ptr)
+  {
+    fprintf(stderr, "Failed to create PNG structure\n");
+    EXPORT_EXIT(CLEAN_UP_FILE);
+  }
+  info_ptr = png_create_info_struct(png_ptr);
+  if (!info_ptr)
+  {
+    fprintf(stderr, "Failed to create PNG info structure\n");
+    EXPORT_EXIT(CLEAN_UP_PNG_STRUCT);
+  }
+  if (setjmp(png_jmpbuf(png_ptr)))
+  {
+    fprintf(stderr, "Failed to write PNG\n");
+    EXPORT_EXIT(CLEAN_UP_PNG_STRUCT);
+  }
+  png_init_io(png_ptr, out_fp);
+  /* Out-of-core Mazes may be wider than LibPNG's default limit. */
+  png_set_user_limits(png_ptr, PNG_UINT_31_MAX, PNG_UINT_31_MAX);
+  png_set_IHDR(png_ptr, info_ptr,
+    width, height,
+    BIT_DEPTH /* Bit Depth */,
+    PNG_COLOR_TYPE_RGB /* Color Type */,
+    PNG_INTERLACE_NONE /* Interlace Type */,
+    PNG_COMPRESSION_TYPE_DEFAULT /* Compression Type */,
+    PNG_FILTER_TYPE_DEFAULT /* Filter Type */);
+  png_write_info(png_ptr, info_ptr);
+
+  /* Image rows are produced in Maze row order, each Maze row gives the
+   * cell rows and the wall rows to the next Maze row. */
+  for (i = 0; i < img_config.border_width; i++) png_write_row(png_ptr, border_row);
+  for (row = 0; row < mheight; row++)
+  {
+    if (!ReadMazeFileRow(file, row_conns))
+    {
+      fprintf(stderr, "Failed to read maze file row %lu\n", row);
+      EXPORT_EXIT(CLEAN_UP_PNG_STRUCT);
+    }
+    FillPNGRowSpan(cell_row, 0, width, &img_config.border_color);
+    FillPNGRowSpan(wall_row, 0, width, &img_config.border_color);
+    px = img_config.border_width;
+    for (col = 0; col < mwidth; col++)
+    {
+      FillPNGRowSpan(cell_row, px, img_config.cell_width,
+        &img_config.default_cell_color);
+      FillPNGRowSpan(wall_row, px, img_config.cell_width,
+        (row_conns[col] & MAZE_CONN_UP) ?
+          &img_config.default_conn_color : &img_config.wall_color);
+      px += img_config.cell_width;
+      if ((col + 1) == mwidth) break;
+      FillPNGRowSpan(cell_row, px, img_config.wall_width,
+        (row_conns[col] & MAZE_CONN_RIGHT) ?
+          &img_config.default_conn_color : &img_config.wall_color);
+      FillPNGRowSpan(wall_row, px, img_config.wall_width,
+        &img_config.wall_color);
+      px += img_config.wall_width;
+    }
+    for (i = 0; i < img_config.cell_width; i++) png_write_row(png_ptr, cell_row);
+    if ((row + 1) == mheight) break;
+    for (i = 0; i < img_config.wall_width; i++) png_write_row(png_ptr, wall_row);
+  }
+  for (i = 0; i < img_config.border_width; i++) png_write_row(png_ptr, border_row);
+  png_write_end(png_ptr, NULL);
+
+  /* Progressive cleanup code. */
+CLEAN_UP_PNG_STRUCT:
+  if (png_ptr)
+  {
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+    png_ptr = NULL;
+    info_ptr = NULL;
+  }
+CLEAN_UP_FILE:
+  if (out_fp)
+  {
+    fclose(out_fp);
+    out_fp = NULL;
+  }
+CLEAN_UP_ROW_DATA:
+  free(row_conns);
+  free(cell_row);
+  free(wall_row);
+  free(border_row);
+  if (exit_on_cleanup)
+  {
+    exit(EXIT_FAILURE);
+  }
+}
+
 #undef EXPORT_EXIT
 #endif /* _NO_PNG */
 
@@ -544,6 +736,51 @@ static void DrawMazeImageCells(maze_image_t *image, maze_t const *maze)
   }
 }
 
+static void DrawMazeImageGap(
+  maze_image_t *image, maze_t const *maze,
+  point_t const *mpos, maze_dir_t dir)
+{
+  point_t ipos, npos;
+  rgb_t color;
+  maze_cell_t *cell;
+  size_t height, width;
+  npos = *mpos;
+  if (!StepMazePoint(&npos, dir, MazeHeight(maze), MazeWidth(maze))) return;
+  cell = GetMazeCell(maze, mpos);
+  if (GetMazeCellConnections(cell) & MazeDirToConn(dir))
+  {
+    GetConnColor(image, cell, GetMazeCell(maze, &npos), &color);
+  }
+  else
+  {
+    color = image->config.wall_color;
+  }
+  MazePositionToMazeImagePosition(image, mpos, &ipos);
+  height = image->config.cell_width;
+  width = image->config.cell_width;
+  switch (dir)
+  {
+    case MAZE_DIR_UP:
+      ipos.row += image->config.cell_width;
+      height = image->config.wall_width;
+      break;
+    case MAZE_DIR_DOWN:
+      ipos.row -= image->config.wall_width;
+      height = image->config.wall_width;
+      break;
+    case MAZE_DIR_LEFT:
+      ipos.col -= image->config.wall_width;
+      width = image->config.wall_width;
+      break;
+    case MAZE_DIR_RIGHT:
+    default:
+      ipos.col += image->config.cell_width;
+      width = image->config.wall_width;
+      break;
+  }
+  DrawRectangleOnMazeImage(image, &ipos, height, width, &color);
+}
+
 static void DrawRectangleOnMazeImage(
   maze_image_t *image,
   point_t const *corner,
@@ -600,6 +837,61 @@ static void SetMazeImageCellColorIfUnset(
   if (!SetGridCell(image->pixels, pos, new_color)) FreeColor(new_color);
 }
 
+static void DrawPathCellOnMazeImage(
+  maze_image_t *image, point_t const *pos, point_t const *prev,
+  rgb_t const *color)
+{
+  point_t ipos;
+  /* Fill cell. */
+  MazePositionToMazeImagePosition(image, pos, &ipos);
+  DrawRectangleOnMazeImage(
+    image, &ipos,
+    image->config.cell_width, image->config.cell_width,
+    color);
+  /* Fill connection. */
+  if (!prev || image->config.wall_width == 0) return;
+  /* Can only fill connections of consecutive points are adjacent. */
+  if (!PositionsAreAdjacent(pos, prev)) return;
+
+  /* DrawRectangle: h, w */
+  if (pos->row < prev->row)
+  {
+    /* Case: Current cell is a row below */
+    ipos.row += image->config.cell_width;
+    DrawRectangleOnMazeImage(
+      image, &ipos,
+      image->config.wall_width, image->config.cell_width,
+      color);
+  }
+  else if (pos->row > prev->row)
+  {
+    /* Case: Current cell is a row above */
+    ipos.row -= image->config.wall_width;
+    DrawRectangleOnMazeImage(
+      image, &ipos,
+      image->config.wall_width, image->config.cell_width,
+      color);
+  }
+  else if (pos->col < prev->col)
+  {
+    /* Case: Current cell is a column below */
+    ipos.col += image->config.cell_width;
+    DrawRectangleOnMazeImage(
+      image, &ipos,
+      image->config.cell_width, image->config.wall_width,
+      color);
+  }
+  else
+  {
+    /* Case: Current cell is a column above */
+    ipos.col -= image->config.wall_width;
+    DrawRectangleOnMazeImage(
+      image, &ipos,
+      image->config.cell_width, image->config.wall_width,
+      color);
+  }
+}
+
 static bool_t PositionsAreAdjacent(point_t const *a, point_t const *b)
 {
   /* Check that they share a row or a column */
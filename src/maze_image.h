@@ -13,6 +13,8 @@
 #include "color.h"
 #include "common.h"
 #include "maze.h"
+#include "maze_file.h"
+#include "maze_path.h"
 
 /* - - Maze Image Config - - */
 
@@ -134,6 +136,33 @@ void DrawPathOnMazeImage(
   maze_image_t *image,
   point_t const *path, size_t path_length,
   rgb_t const *path_color);
+/* Same as DrawPathOnMazeImage(), for a compact Maze Path. */
+void DrawMazePathOnMazeImage(
+  maze_image_t *image, maze_path_t const *path, rgb_t const *path_color);
+
+/*
+ * Redraw Maze Image Cells
+ *  Redraws the given Maze Cells and the wall or connection on each of
+ *  their sides, using the original config.  Useful after a small change
+ *  to the Maze (see ShiftMazeOrigin()), instead of creating a new
+ *  image.  The Maze must have the same dimensions as the one the image
+ *  was created from.
+ */
+void RedrawMazeImageCells(
+  maze_image_t *image, maze_t const *maze,
+  point_t const *cells, size_t cell_count);
+
+/*
+ * Open Maze Image Border
+ *  Draws a gap in the border next to the Maze Cell at `mpos`, on its
+ *  side facing `dir`, as if the cell had a connection leading out of
+ *  the Maze.  The gap uses the connection color of the cell.  Nothing
+ *  is drawn if the cell is not on that side of the Maze.  Used to show
+ *  the openings between Maze World tiles (see maze_world.h).
+ */
+void OpenMazeImageBorder(
+  maze_image_t *image, maze_t const *maze,
+  point_t const *mpos, maze_dir_t dir);
 
 #ifndef _NO_PNG
 /*
@@ -153,6 +182,21 @@ void DrawPathOnMazeImage(
  *  standard error.
  */
 void ExportMazeImageToPNG(maze_image_t const *image, char const *png_path);
+
+/*
+ * Exports a Maze File to a file in PNG format.
+ *  Reads the rest of the Maze File row by row and writes the image rows
+ *  as they are made, so no Maze or Maze Image is ever held in memory.
+ *  The file should not have been read from yet.  Only the sizes and
+ *  fixed colors of the config are used (default cell and connection
+ *  colors), as there are no Maze Cells to pass to color generators.
+ *  If `config` is NULL, then the default values are used.
+ *
+ * IMPORTANT: like ExportMazeImageToPNG(), this function will exit the
+ *  program on error.
+ */
+void ExportMazeFileToPNG(
+  maze_file_t *file, maze_image_config_t const *config, char const *png_path);
 #endif /* _NO_PNG */
 
 
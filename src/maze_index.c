@@ -0,0 +1,319 @@
+/*
+ * Mazart - Maze Path Index
+ *  Module provides an index over a perfect Maze which answers path
+ *  queries between any two cells without searching the Maze.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define RMQ_BLOCK 64
+#define NO_PARENT 0xFF
+#define NO_ORDER UINT32_MAX
+
+/* - - Maze Path Index Structure - - */
+
+struct maze_path_index_st {
+  size_t height;
+  size_t width;
+  size_t reached;       /* Cells connected to the root. */
+  uint8_t *parents;     /* Maze Direction to parent, per cell. */
+  uint32_t *depths;     /* Steps from the root, per cell. */
+  uint32_t *orders;     /* Depth-first position, per cell. */
+  uint32_t *cells;      /* Cell, per depth-first position. */
+  uint64_t *masks;      /* In-block minima, per depth-first position. */
+  uint32_t **sparse;    /* [level][block] shallowest position. */
+  size_t levels;
+};
+
+/* - - Maze Path Index Internal API - - */
+
+static inline uint32_t PositionDepth(
+  maze_path_index_t const *index, uint32_t pos)
+{
+  return index->depths[index->cells[pos]];
+}
+
+static inline uint32_t ShallowerPosition(
+  maze_path_index_t const *index, uint32_t a, uint32_t b)
+{
+  return PositionDepth(index, b) < PositionDepth(index, a) ? b : a;
+}
+
+/* Shallowest position in [l, r], both in the same block.  The mask of
+ * `r` marks the positions that are the minimum of the block from them
+ * up to `r`, so the first one at or after `l` is the answer. */
+static inline uint32_t QueryRmqBlock(
+  maze_path_index_t const *index, size_t l, size_t r)
+{
+  uint64_t mask;
+  mask = index->masks[r] & (~UINT64_C(0) << (l % RMQ_BLOCK));
+  return (uint32_t) ((l - l % RMQ_BLOCK) + __builtin_ctzll(mask));
+}
+
+/* Shallowest position in [l, r]. */
+static uint32_t QueryRmq(maze_path_index_t const *index, size_t l, size_t r)
+{
+  size_t lb, rb, level;
+  uint32_t best;
+  lb = l / RMQ_BLOCK;
+  rb = r / RMQ_BLOCK;
+  if (lb == rb) return QueryRmqBlock(index, l, r);
+  best = ShallowerPosition(index,
+    QueryRmqBlock(index, l, lb * RMQ_BLOCK + RMQ_BLOCK - 1),
+    QueryRmqBlock(index, rb * RMQ_BLOCK, r));
+  if (lb + 1 < rb)
+  {
+    lb++;
+    rb--;
+    level = 63 - __builtin_clzll((uint64_t) (rb - lb + 1));
+    best = ShallowerPosition(index, best, index->sparse[level][lb]);
+    best = ShallowerPosition(index, best,
+      index->sparse[level][rb + 1 - ((size_t) 1 << level)]);
+  }
+  return best;
+}
+
+/* Builds parents, depths and the depth-first order.  The walk
+ * backtracks through the parent directions, so no stack is needed. */
+static void BuildPathIndexTree(maze_path_index_t *index, maze_t const *maze)
+{
+  maze_conn_t const *conns;
+  point_t start;
+  size_t root, idx, next, d;
+  conns = GetMazeConnections(maze);
+  MazeStart(maze, &start);
+  root = start.row * index->width + start.col;
+  idx = root;
+  index->parents[idx] = MAZE_DIR_COUNT;
+  index->depths[idx] = 0;
+  index->orders[idx] = 0;
+  index->cells[0] = (uint32_t) idx;
+  index->reached = 1;
+  d = 0;
+  while (true)
+  {
+    for (; d < MAZE_DIR_COUNT; d++)
+    {
+      if (!(conns[idx] & MazeDirToConn(d))) continue;
+      next = StepMazeIndex(idx, (maze_dir_t) d, index->width);
+      if (index->parents[next] != NO_PARENT) continue;
+      break;
+    }
+    if (d < MAZE_DIR_COUNT)
+    {
+      index->parents[next] = (uint8_t) OppositeMazeDir((maze_dir_t) d);
+      index->depths[next] = index->depths[idx] + 1;
+      index->orders[next] = (uint32_t) index->reached;
+      index->cells[index->reached++] = (uint32_t) next;
+      idx = next;
+      d = 0;
+      continue;
+    }
+    if (idx == root) break;
+    d = OppositeMazeDir((maze_dir_t) index->parents[idx]) + 1;
+    idx = StepMazeIndex(idx, (maze_dir_t) index->parents[idx], index->width);
+  }
+}
+
+static void BuildPathIndexRmq(maze_path_index_t *index)
+{
+  size_t blocks, block, level, pos, first, last, span;
+  uint64_t stack;
+  int top;
+  /* In-block minima masks. */
+  for (first = 0; first < index->reached; first += RMQ_BLOCK)
+  {
+    last = first + RMQ_BLOCK;
+    if (last > index->reached) last = index->reached;
+    stack = 0;
+    for (pos = first; pos < last; pos++)
+    {
+      while (stack)
+      {
+        top = 63 - __builtin_clzll(stack);
+        if (PositionDepth(index, (uint32_t) (first + top))
+            < PositionDepth(index, (uint32_t) pos)) break;
+        stack ^= UINT64_C(1) << top;
+      }
+      stack |= UINT64_C(1) << (pos - first);
+      index->masks[pos] = stack;
+    }
+  }
+  /* Sparse table over blocks. */
+  blocks = (index->reached + RMQ_BLOCK - 1) / RMQ_BLOCK;
+  index->levels = 1;
+  while (((size_t) 1 << index->levels) <= blocks) index->levels++;
+  index->sparse = (uint32_t**)calloc(index->levels, sizeof(uint32_t*));
+  index->sparse[0] = (uint32_t*)malloc(blocks * sizeof(uint32_t));
+  for (block = 0; block < blocks; block++)
+  {
+    last = block * RMQ_BLOCK + RMQ_BLOCK - 1;
+    if (last >= index->reached) last = index->reached - 1;
+    index->sparse[0][block] = QueryRmqBlock(index, block * RMQ_BLOCK, last);
+  }
+  for (level = 1; level < index->levels; level++)
+  {
+    span = (size_t) 1 << level;
+    index->sparse[level] =
+      (uint32_t*)malloc((blocks - span + 1) * sizeof(uint32_t));
+    for (block = 0; block + span <= blocks; block++)
+    {
+      index->sparse[level][block] = ShallowerPosition(index,
+        index->sparse[level - 1][block],
+        index->sparse[level - 1][block + span / 2]);
+    }
+  }
+}
+
+/* Cell index of a point, or SIZE_MAX if it is not in the tree. */
+static size_t PathIndexCell(maze_path_index_t const *index, point_t const *pos)
+{
+  size_t idx;
+  if (!pos || pos->row >= index->height || pos->col >= index->width)
+    return SIZE_MAX;
+  idx = pos->row * index->width + pos->col;
+  if (index->orders[idx] == NO_ORDER) return SIZE_MAX;
+  return idx;
+}
+
+static size_t FindPathIndexLca(
+  maze_path_index_t const *index, size_t a, size_t b)
+{
+  size_t l, r, cell;
+  if (a == b) return a;
+  l = index->orders[a];
+  r = index->orders[b];
+  if (l > r)
+  {
+    l = index->orders[b];
+    r = index->orders[a];
+  }
+  cell = index->cells[QueryRmq(index, l + 1, r)];
+  return StepMazeIndex(cell, (maze_dir_t) index->parents[cell], index->width);
+}
+
+/* - - Maze Path Index API - - */
+
+maze_path_index_t *CreateMazePathIndex(maze_t const *maze)
+{
+  maze_path_index_t *index;
+  size_t count;
+  if (!maze) return NULL;
+  count = MazeHeight(maze) * MazeWidth(maze);
+  if (count == 0 || count >= UINT32_MAX) return NULL;
+  index = (maze_path_index_t*)calloc(1, sizeof(maze_path_index_t));
+  index->height = MazeHeight(maze);
+  index->width = MazeWidth(maze);
+  index->parents = (uint8_t*)malloc(count * sizeof(uint8_t));
+  index->depths = (uint32_t*)calloc(count, sizeof(uint32_t));
+  index->orders = (uint32_t*)malloc(count * sizeof(uint32_t));
+  index->cells = (uint32_t*)calloc(count, sizeof(uint32_t));
+  index->masks = (uint64_t*)calloc(count, sizeof(uint64_t));
+  memset(index->parents, NO_PARENT, count * sizeof(uint8_t));
+  memset(index->orders, 0xFF, count * sizeof(uint32_t));
+  BuildPathIndexTree(index, maze);
+  BuildPathIndexRmq(index);
+  return index;
+}
+
+void FreeMazePathIndex(maze_path_index_t *index)
+{
+  size_t level;
+  if (!index) return;
+  for (level = 0; level < index->levels; level++) free(index->sparse[level]);
+  free(index->sparse);
+  free(index->parents);
+  free(index->depths);
+  free(index->orders);
+  free(index->cells);
+  free(index->masks);
+  memset(index, 0, sizeof(maze_path_index_t));
+  free(index);
+}
+
+size_t MazePathIndexDistance(
+  maze_path_index_t const *index, point_t const *a, point_t const *b)
+{
+  size_t ia, ib, lca;
+  if (!index) return SIZE_MAX;
+  ia = PathIndexCell(index, a);
+  ib = PathIndexCell(index, b);
+  if (ia == SIZE_MAX || ib == SIZE_MAX) return SIZE_MAX;
+  lca = FindPathIndexLca(index, ia, ib);
+  return index->depths[ia] + index->depths[ib] - 2 * (size_t) index->depths[lca];
+}
+
+bool_t FindMazePathIndexAncestor(
+  maze_path_index_t const *index, point_t const *a, point_t const *b,
+  point_t *ancestor)
+{
+  size_t ia, ib, lca;
+  if (!index || !ancestor) return false;
+  ia = PathIndexCell(index, a);
+  ib = PathIndexCell(index, b);
+  if (ia == SIZE_MAX || ib == SIZE_MAX) return false;
+  lca = FindPathIndexLca(index, ia, ib);
+  ancestor->row = lca / index->width;
+  ancestor->col = lca % index->width;
+  return true;
+}
+
+size_t GetMazePathIndexPath(
+  maze_path_index_t const *index, point_t const *a, point_t const *b,
+  point_t *path, size_t max_path)
+{
+  size_t ia, ib, lca, length, up, i;
+  if (!index) return 0;
+  ia = PathIndexCell(index, a);
+  ib = PathIndexCell(index, b);
+  if (ia == SIZE_MAX || ib == SIZE_MAX) return 0;
+  lca = FindPathIndexLca(index, ia, ib);
+  up = index->depths[ia] - index->depths[lca];
+  length = up + (index->depths[ib] - index->depths[lca]) + 1;
+  if (!path || length > max_path) return length;
+  /* `a` climbs to the LCA from the front, `b` from the back. */
+  for (i = 0; i <= up; i++)
+  {
+    path[i].row = ia / index->width;
+    path[i].col = ia % index->width;
+    if (i < up) ia = StepMazeIndex(ia, (maze_dir_t) index->parents[ia], index->width);
+  }
+  for (i = length - 1; i > up; i--)
+  {
+    path[i].row = ib / index->width;
+    path[i].col = ib % index->width;
+    ib = StepMazeIndex(ib, (maze_dir_t) index->parents[ib], index->width);
+  }
+  return length;
+}
+
+size_t AnswerMazePathQueries(
+  maze_path_index_t const *index, FILE *queries, FILE *answers)
+{
+  char line[256];
+  unsigned long a_row, a_col, b_row, b_col;
+  point_t a, b;
+  size_t count, distance;
+  if (!index || !queries || !answers) return 0;
+  count = 0;
+  while (fgets(line, sizeof(line), queries))
+  {
+    if (sscanf(line, "%lu %lu %lu %lu", &a_row, &a_col, &b_row, &b_col) != 4)
+      continue;
+    a = (point_t) {.row = a_row, .col = a_col};
+    b = (point_t) {.row = b_row, .col = b_col};
+    distance = MazePathIndexDistance(index, &a, &b);
+    if (distance == SIZE_MAX)
+      fprintf(answers, "%lu %lu %lu %lu -1\n", a_row, a_col, b_row, b_col);
+    else
+      fprintf(answers, "%lu %lu %lu %lu %lu\n", a_row, a_col, b_row, b_col, distance);
+    count++;
+  }
+  return count;
+}
@@ -0,0 +1,63 @@
+/*
+ * Mazart - Maze Path Index
+ *  Module provides an index over a perfect Maze which answers path
+ *  queries between any two cells without searching the Maze.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_INDEX_H_
+#define _MAZE_INDEX_H_
+
+#include <stdio.h>
+
+#include "common.h"
+#include "maze.h"
+
+/*
+ * Maze Path Index
+ *  A perfect Maze is a tree, so the path between two cells goes
+ *  through their lowest common ancestor (LCA).  The index roots the
+ *  Maze at its start and stores the parent direction, depth and
+ *  depth-first order of every cell.  An LCA is the parent of the
+ *  shallowest cell between the two cells in depth-first order, which is
+ *  found with a constant time range-minimum query: a sparse table over
+ *  blocks of 64 cells, and a bit-mask of in-block minima per cell.
+ *
+ *  The index is a snapshot, and must be rebuilt if the Maze changes.
+ *  Mazes of 2^32 cells or more are not supported.
+ */
+typedef struct maze_path_index_st maze_path_index_t;
+
+/* - - Maze Path Index API - - */
+
+/* Maze Path Index constructor.  Builds the index in O(cells).  Returns
+ * NULL if the Maze is too large. */
+maze_path_index_t *CreateMazePathIndex(maze_t const *maze);
+void FreeMazePathIndex(maze_path_index_t *index);
+
+/* Number of steps between `a` and `b`, in O(1).  Returns SIZE_MAX if
+ * either cell is outside the Maze or not connected to the start. */
+size_t MazePathIndexDistance(
+  maze_path_index_t const *index, point_t const *a, point_t const *b);
+/* Lowest common ancestor of `a` and `b`, with the Maze rooted at its
+ * start.  Returns false if there is none. */
+bool_t FindMazePathIndexAncestor(
+  maze_path_index_t const *index, point_t const *a, point_t const *b,
+  point_t *ancestor);
+/* Path from `a` to `b` in O(path length), with the same contract as
+ * SolveMazeBfs(): returns the length in cells, or 0 if there is no
+ * path, and only writes the path if it fits in `max_path` points. */
+size_t GetMazePathIndexPath(
+  maze_path_index_t const *index, point_t const *a, point_t const *b,
+  point_t *path, size_t max_path);
+
+/* Answers a batch of queries.  Each line of `queries` holds two cells
+ * as "row col row col", and the line written to `answers` repeats them
+ * followed by their distance in steps, or -1 if there is no path.
+ * Returns the number of queries answered. */
+size_t AnswerMazePathQueries(
+  maze_path_index_t const *index, FILE *queries, FILE *answers);
+
+#endif /* _MAZE_INDEX_H_ */
@@ -0,0 +1,261 @@
+/*
+ * Mazart - Packed Row Maze Generators
+ *  Module provides bit-parallel binary-tree and sidewinder Maze
+ *  generators.  Both make every decision locally within a row, so rows
+ *  are generated as packed wall bits, 64 cells per random word, and
+ *  bands of rows are generated in parallel.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_packed.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rng.h"
+#include "thread_pool.h"
+
+/* Mazes with fewer cells than this are generated on the calling
+ * thread. */
+static size_t const kPackedParallelCells = 65536;
+/* Number of bands per worker thread, for load balancing. */
+static size_t const kPackedBandsPerThread = 4;
+
+#define PACKED_WORD_BITS 64
+
+/* - - Packed Maze Structures - - */
+
+typedef enum {
+  PACKED_BINARY_TREE,
+  PACKED_SIDEWINDER
+} packed_algorithm_t;
+
+/* Bit planes of the Maze, one bit per cell.  Bit `b` of word `w` of a
+ * row is column `w * 64 + b`. */
+typedef struct {
+  packed_algorithm_t algorithm;
+  maze_conn_t *conns;
+  size_t height;
+  size_t width;
+  size_t words;      /* Words per row. */
+  uint64_t *up;      /* Cell connects to the next row. */
+  uint64_t *right;   /* Cell connects to the next column. */
+  uint64_t seed;     /* Row random streams are drawn from this seed. */
+} packed_maze_t;
+
+typedef struct {
+  packed_maze_t *packed;
+  size_t first_row;
+  size_t end_row;
+} packed_band_t;
+
+/* - - Packed Maze Internal API - - */
+
+/* Bits of the word that are inside the Maze. */
+static inline uint64_t PackedValidMask(packed_maze_t const *packed, size_t word)
+{
+  size_t cols;
+  cols = packed->width - word * PACKED_WORD_BITS;
+  if (cols >= PACKED_WORD_BITS) return ~UINT64_C(0);
+  return (UINT64_C(1) << cols) - 1;
+}
+
+/* Bits of the word that have a column to their right. */
+static inline uint64_t PackedRightValidMask(packed_maze_t const *packed, size_t word)
+{
+  size_t cols;
+  if (packed->width - 1 < word * PACKED_WORD_BITS) return 0;
+  cols = packed->width - 1 - word * PACKED_WORD_BITS;
+  if (cols >= PACKED_WORD_BITS) return ~UINT64_C(0);
+  return (UINT64_C(1) << cols) - 1;
+}
+
+static void GenerateBinaryTreeRow(packed_maze_t *packed, size_t row, rng_t *rng)
+{
+  uint64_t *up, *right;
+  size_t word;
+  bool_t last_row;
+  up = &packed->up[row * packed->words];
+  right = &packed->right[row * packed->words];
+  last_row = (row + 1) == packed->height;
+  for (word = 0; word < packed->words; word++)
+  {
+    if (last_row)
+    {
+      right[word] = PackedRightValidMask(packed, word);
+      up[word] = 0;
+      continue;
+    }
+    /* Set bits go right, clear bits (and the last column) go up. */
+    right[word] = NextRng(rng) & PackedRightValidMask(packed, word);
+    up[word] = ~right[word] & PackedValidMask(packed, word);
+  }
+}
+
+static void GenerateSidewinderRow(packed_maze_t *packed, size_t row, rng_t *rng)
+{
+  uint64_t *up, *right;
+  uint64_t runs, ends, starts, picks, sum, carry, next_carry, run_carry;
+  size_t word;
+  up = &packed->up[row * packed->words];
+  right = &packed->right[row * packed->words];
+  if ((row + 1) == packed->height)
+  {
+    /* Last row is a single run. */
+    for (word = 0; word < packed->words; word++)
+    {
+      right[word] = PackedRightValidMask(packed, word);
+      up[word] = 0;
+    }
+    return;
+  }
+  carry = 0;
+  run_carry = 0;
+  for (word = 0; word < packed->words; word++)
+  {
+    runs = NextRng(rng) & PackedRightValidMask(packed, word);
+    /* A run ends on every cell that does not go right, and starts
+     * after every end. */
+    ends = ~runs;
+    starts = ~((runs << 1) | run_carry);
+    run_carry = runs >> (PACKED_WORD_BITS - 1);
+    /* Every run picks a random set of cells, always including its last
+     * cell.  Adding the run starts to the inverted picks carries from
+     * each start to the first pick of its run, and stops there.  Runs
+     * spanning words carry into the next word. */
+    picks = NextRng(rng) | ends;
+    sum = ~picks + starts;
+    next_carry = sum < starts;
+    sum += carry;
+    carry = next_carry | (sum < carry);
+    up[word] = sum & picks & PackedValidMask(packed, word);
+    right[word] = runs;
+  }
+}
+
+static void GeneratePackedBand(void *vband)
+{
+  packed_band_t *band;
+  rng_t rng;
+  size_t row;
+  band = vband;
+  for (row = band->first_row; row < band->end_row; row++)
+  {
+    SeedRngStream(&rng, band->packed->seed, row);
+    if (band->packed->algorithm == PACKED_SIDEWINDER)
+      GenerateSidewinderRow(band->packed, row, &rng);
+    else
+      GenerateBinaryTreeRow(band->packed, row, &rng);
+  }
+}
+
+/* Converts the band's bit planes into Maze Connection masks.  Only the
+ * band's own rows are written, connections to the previous row are
+ * read from its up plane. */
+static void ExpandPackedBand(void *vband)
+{
+  packed_band_t *band;
+  packed_maze_t *packed;
+  maze_conn_t *conns;
+  uint64_t up, down, left, right, left_carry;
+  size_t row, word, col, bit, bits;
+  band = vband;
+  packed = band->packed;
+  for (row = band->first_row; row < band->end_row; row++)
+  {
+    conns = &packed->conns[row * packed->width];
+    left_carry = 0;
+    for (word = 0; word < packed->words; word++)
+    {
+      up = packed->up[row * packed->words + word];
+      down = row > 0 ? packed->up[(row - 1) * packed->words + word] : 0;
+      right = packed->right[row * packed->words + word];
+      left = (right << 1) | left_carry;
+      left_carry = right >> (PACKED_WORD_BITS - 1);
+      col = word * PACKED_WORD_BITS;
+      bits = packed->width - col;
+      if (bits > PACKED_WORD_BITS) bits = PACKED_WORD_BITS;
+      for (bit = 0; bit < bits; bit++)
+      {
+        conns[col + bit] = (maze_conn_t) (
+          (((up >> bit) & 1) << MAZE_DIR_UP)
+          | (((down >> bit) & 1) << MAZE_DIR_DOWN)
+          | (((left >> bit) & 1) << MAZE_DIR_LEFT)
+          | (((right >> bit) & 1) << MAZE_DIR_RIGHT));
+      }
+    }
+  }
+}
+
+static void RunPackedBands(
+  thread_pool_t *pool, packed_band_t *bands, size_t band_count,
+  thread_task_t task)
+{
+  size_t i;
+  for (i = 0; i < band_count; i++)
+  {
+    if (!pool || !SubmitThreadTask(pool, task, &bands[i])) task(&bands[i]);
+  }
+  WaitThreadPool(pool);
+}
+
+static void DrawPackedMaze(maze_t *maze, packed_algorithm_t algorithm)
+{
+  packed_maze_t packed;
+  packed_band_t *bands;
+  thread_pool_t *pool;
+  rng_t rng;
+  size_t band_count, band_rows, i;
+  if (!maze) return;
+  memset(&packed, 0, sizeof(packed_maze_t));
+  packed.algorithm = algorithm;
+  packed.conns = GetMazeConnectionsMutable(maze);
+  packed.height = MazeHeight(maze);
+  packed.width = MazeWidth(maze);
+  packed.words = (packed.width + PACKED_WORD_BITS - 1) / PACKED_WORD_BITS;
+  packed.up = (uint64_t*)calloc(packed.height * packed.words, sizeof(uint64_t));
+  packed.right = (uint64_t*)calloc(packed.height * packed.words, sizeof(uint64_t));
+  SplitMazeRng(maze, &rng);
+  packed.seed = NextRng(&rng);
+
+  pool = NULL;
+  band_count = 1;
+  if (packed.height * packed.width >= kPackedParallelCells)
+  {
+    pool = CreateThreadPool(0);
+    if (pool) band_count = ThreadPoolSize(pool) * kPackedBandsPerThread;
+  }
+  band_rows = (packed.height + band_count - 1) / band_count;
+  band_count = (packed.height + band_rows - 1) / band_rows;
+  bands = (packed_band_t*)calloc(band_count, sizeof(packed_band_t));
+  for (i = 0; i < band_count; i++)
+  {
+    bands[i].packed = &packed;
+    bands[i].first_row = i * band_rows;
+    bands[i].end_row = (i + 1) * band_rows;
+    if (bands[i].end_row > packed.height) bands[i].end_row = packed.height;
+  }
+  /* Every band must be generated before any is expanded, as expanding
+   * reads the previous row's bits. */
+  RunPackedBands(pool, bands, band_count, GeneratePackedBand);
+  RunPackedBands(pool, bands, band_count, ExpandPackedBand);
+
+  FreeThreadPool(pool);
+  free(bands);
+  free(packed.up);
+  free(packed.right);
+}
+
+/* - - Packed Maze API - - */
+
+void DrawBinaryTreeMaze(maze_t *maze)
+{
+  DrawPackedMaze(maze, PACKED_BINARY_TREE);
+}
+
+void DrawSidewinderMaze(maze_t *maze)
+{
+  DrawPackedMaze(maze, PACKED_SIDEWINDER);
+}
@@ -0,0 +1,30 @@
+/*
+ * Mazart - Packed Row Maze Generators
+ *  Module provides bit-parallel binary-tree and sidewinder Maze
+ *  generators.  Both make every decision locally within a row, so rows
+ *  are generated as packed wall bits, 64 cells per random word, and
+ *  bands of rows are generated in parallel.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_PACKED_H_
+#define _MAZE_PACKED_H_
+
+#include "common.h"
+#include "maze.h"
+
+/* Draws the Maze's connections using the binary-tree algorithm.  Each
+ * cell connects either up or right.  The Maze connections are expected
+ * to be cleared. */
+void DrawBinaryTreeMaze(maze_t *maze);
+
+/* Draws the Maze's connections using the sidewinder algorithm.  Each
+ * row is split into random runs of right connections, and every run
+ * connects up once.  The cell of the run that connects up is the first
+ * one picked by a random bit mask, so it favours the start of the run.
+ * The Maze connections are expected to be cleared. */
+void DrawSidewinderMaze(maze_t *maze);
+
+#endif /* _MAZE_PACKED_H_ */
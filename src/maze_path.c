@@ -0,0 +1,301 @@
+/*
+ * Mazart - Maze Path
+ *  Module provides a compact Maze path, stored as its start cell and
+ *  one 2-bit Maze Direction per step.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_path.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STEPS_PER_WORD 32
+#define STEPS_PER_BYTE 4
+#define MAZE_PATH_HEADER_SZ 32
+#define MAZE_PATH_CHUNK_SZ 4096
+
+/* Initial step capacity in words, grows by doubling. */
+static size_t const kMazePathWords = 4;
+
+static uint8_t const kMazePathMagic[8] = {'M', 'Z', 'P', 'A', 'T', 'H', 0, 1};
+
+/* - - Maze Path Structure - - */
+
+struct maze_path_st {
+  point_t start;
+  point_t end;
+  size_t steps;
+  size_t capacity;    /* In words. */
+  uint64_t *words;
+};
+
+/* - - Maze Path Internal API - - */
+
+static inline maze_dir_t GetStep(uint64_t const *words, size_t step)
+{
+  return (maze_dir_t) ((words[step / STEPS_PER_WORD]
+    >> (2 * (step % STEPS_PER_WORD))) & 0x3);
+}
+
+static inline void SetStep(uint64_t *words, size_t step, maze_dir_t dir)
+{
+  size_t word, shift;
+  word = step / STEPS_PER_WORD;
+  shift = 2 * (step % STEPS_PER_WORD);
+  words[word] &= ~(((uint64_t) 0x3) << shift);
+  words[word] |= ((uint64_t) dir) << shift;
+}
+
+/* Direction from `a` to an adjacent `b`.  Returns false if the points
+ * are not adjacent. */
+static bool_t PointsToMazeDir(point_t const *a, point_t const *b, maze_dir_t *dir)
+{
+  if (a->col == b->col)
+  {
+    if (b->row == a->row + 1) *dir = MAZE_DIR_UP;
+    else if (a->row == b->row + 1) *dir = MAZE_DIR_DOWN;
+    else return false;
+  }
+  else if (a->row == b->row)
+  {
+    if (b->col == a->col + 1) *dir = MAZE_DIR_RIGHT;
+    else if (a->col == b->col + 1) *dir = MAZE_DIR_LEFT;
+    else return false;
+  }
+  else return false;
+  return true;
+}
+
+static void EncodePathWord(uint8_t *buf, uint64_t value)
+{
+  size_t i;
+  for (i = 0; i < 8; i++) buf[i] = (uint8_t) (value >> (8 * i));
+}
+
+static uint64_t DecodePathWord(uint8_t const *buf)
+{
+  uint64_t value;
+  size_t i;
+  value = 0;
+  for (i = 0; i < 8; i++) value |= ((uint64_t) buf[i]) << (8 * i);
+  return value;
+}
+
+/* - - Maze Path API - - */
+
+maze_path_t *CreateMazePath(point_t const *start)
+{
+  maze_path_t *path;
+  if (!start) return NULL;
+  path = (maze_path_t*)calloc(1, sizeof(maze_path_t));
+  path->start = *start;
+  path->end = *start;
+  path->capacity = kMazePathWords;
+  path->words = (uint64_t*)calloc(path->capacity, sizeof(uint64_t));
+  return path;
+}
+
+maze_path_t *CreateMazePathFromPoints(point_t const *points, size_t count)
+{
+  maze_path_t *path;
+  maze_dir_t dir;
+  size_t i;
+  if (!points || count == 0) return NULL;
+  path = CreateMazePath(&points[0]);
+  for (i = 1; i < count; i++)
+  {
+    if (!PointsToMazeDir(&points[i - 1], &points[i], &dir))
+    {
+      FreeMazePath(path);
+      return NULL;
+    }
+    PushMazePathStep(path, dir);
+  }
+  return path;
+}
+
+void FreeMazePath(maze_path_t *path)
+{
+  if (!path) return;
+  free(path->words);
+  memset(path, 0, sizeof(maze_path_t));
+  free(path);
+}
+
+size_t MazePathLength(maze_path_t const *path)
+{
+  if (!path) return 0;
+  return path->steps + 1;
+}
+
+void MazePathStart(maze_path_t const *path, point_t *start)
+{
+  if (!path || !start) return;
+  *start = path->start;
+}
+
+void MazePathEnd(maze_path_t const *path, point_t *end)
+{
+  if (!path || !end) return;
+  *end = path->end;
+}
+
+maze_dir_t GetMazePathStep(maze_path_t const *path, size_t step)
+{
+  if (!path || step >= path->steps) return MAZE_DIR_UP;
+  return GetStep(path->words, step);
+}
+
+bool_t PushMazePathStep(maze_path_t *path, maze_dir_t dir)
+{
+  size_t word;
+  if (!path) return false;
+  if (!StepMazePoint(&path->end, dir, SIZE_MAX, SIZE_MAX)) return false;
+  word = path->steps / STEPS_PER_WORD;
+  if (word == path->capacity)
+  {
+    path->capacity *= 2;
+    path->words = (uint64_t*)realloc(
+      path->words, path->capacity * sizeof(uint64_t));
+  }
+  if (path->steps % STEPS_PER_WORD == 0) path->words[word] = 0;
+  SetStep(path->words, path->steps, dir);
+  path->steps++;
+  return true;
+}
+
+void ReverseMazePath(maze_path_t *path)
+{
+  maze_dir_t first, last;
+  size_t i, j;
+  if (!path) return;
+  SwapPoints(&path->start, &path->end);
+  for (i = 0, j = path->steps; i < j; i++)
+  {
+    j--;
+    first = GetStep(path->words, i);
+    last = GetStep(path->words, j);
+    SetStep(path->words, i, OppositeMazeDir(last));
+    SetStep(path->words, j, OppositeMazeDir(first));
+  }
+}
+
+size_t MazePathToPoints(
+  maze_path_t const *path, point_t *points, size_t max_points)
+{
+  maze_path_iter_t iter;
+  size_t length;
+  if (!path) return 0;
+  length = MazePathLength(path);
+  if (!points || length > max_points) return length;
+  StartMazePathIter(&iter, path);
+  while (NextMazePathIter(&iter)) points[iter.index - 1] = iter.pos;
+  return length;
+}
+
+/* - - Maze Path Iterator API - - */
+
+void StartMazePathIter(maze_path_iter_t *iter, maze_path_t const *path)
+{
+  if (!iter) return;
+  memset(iter, 0, sizeof(maze_path_iter_t));
+  iter->path = path;
+  if (path) iter->pos = path->start;
+}
+
+bool_t NextMazePathIter(maze_path_iter_t *iter)
+{
+  if (!iter || !iter->path) return false;
+  if (iter->index > iter->path->steps) return false;
+  if (iter->index > 0)
+  {
+    iter->dir = GetStep(iter->path->words, iter->index - 1);
+    StepMazePoint(&iter->pos, iter->dir, SIZE_MAX, SIZE_MAX);
+  }
+  iter->index++;
+  return true;
+}
+
+/* - - Maze Path Files - - */
+
+bool_t WriteMazePathFile(maze_path_t const *path, char const *filename)
+{
+  FILE *fp;
+  uint8_t header[MAZE_PATH_HEADER_SZ];
+  uint8_t chunk[MAZE_PATH_CHUNK_SZ];
+  size_t step, n;
+  bool_t ok;
+  if (!path || !filename) return false;
+  fp = fopen(filename, "wb");
+  if (!fp) return false;
+  memset(header, 0, sizeof(header));
+  memcpy(header, kMazePathMagic, sizeof(kMazePathMagic));
+  EncodePathWord(&header[8], path->start.row);
+  EncodePathWord(&header[16], path->start.col);
+  EncodePathWord(&header[24], path->steps);
+  ok = fwrite(header, 1, sizeof(header), fp) == sizeof(header);
+  for (step = 0; ok && step < path->steps; step += n * STEPS_PER_BYTE)
+  {
+    memset(chunk, 0, sizeof(chunk));
+    for (n = 0; n < sizeof(chunk) && step + n * STEPS_PER_BYTE < path->steps; n++)
+    {
+      /* A byte is a quarter of a word, and the word is little-endian
+       * in the same order as the steps. */
+      chunk[n] = (uint8_t) (path->words[(step / STEPS_PER_BYTE + n) / 8]
+        >> (8 * ((step / STEPS_PER_BYTE + n) % 8)));
+    }
+    ok = fwrite(chunk, 1, n, fp) == n;
+  }
+  if (fclose(fp) != 0) ok = false;
+  return ok;
+}
+
+maze_path_t *ReadMazePathFile(char const *filename)
+{
+  FILE *fp;
+  uint8_t header[MAZE_PATH_HEADER_SZ];
+  uint8_t chunk[MAZE_PATH_CHUNK_SZ];
+  maze_path_t *path;
+  point_t start;
+  uint64_t steps;
+  size_t step, n, i, j;
+  bool_t ok;
+  if (!filename) return NULL;
+  fp = fopen(filename, "rb");
+  if (!fp) return NULL;
+  if (fread(header, 1, sizeof(header), fp) != sizeof(header)
+      || memcmp(header, kMazePathMagic, sizeof(kMazePathMagic)) != 0)
+  {
+    fclose(fp);
+    return NULL;
+  }
+  start.row = (size_t) DecodePathWord(&header[8]);
+  start.col = (size_t) DecodePathWord(&header[16]);
+  steps = DecodePathWord(&header[24]);
+  path = CreateMazePath(&start);
+  /* Steps are replayed so the end is known and a corrupt path, which
+   * leaves the first row or column, is rejected. */
+  ok = true;
+  for (step = 0; ok && step < steps; )
+  {
+    n = (size_t) ((steps - step + STEPS_PER_BYTE - 1) / STEPS_PER_BYTE);
+    if (n > sizeof(chunk)) n = sizeof(chunk);
+    ok = fread(chunk, 1, n, fp) == n;
+    for (i = 0; ok && i < n; i++)
+    for (j = 0; ok && j < STEPS_PER_BYTE && step < steps; j++, step++)
+    {
+      ok = PushMazePathStep(path, (maze_dir_t) ((chunk[i] >> (2 * j)) & 0x3));
+    }
+  }
+  fclose(fp);
+  if (!ok)
+  {
+    FreeMazePath(path);
+    return NULL;
+  }
+  return path;
+}
@@ -0,0 +1,87 @@
+/*
+ * Mazart - Maze Path
+ *  Module provides a compact Maze path, stored as its start cell and
+ *  one 2-bit Maze Direction per step.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_PATH_H_
+#define _MAZE_PATH_H_
+
+#include "common.h"
+#include "maze.h"
+
+/*
+ * Maze Path
+ *  A path of adjacent cells.  Only the start is stored as a point, each
+ *  following cell is the Maze Direction taken from the previous one,
+ *  packed 32 to a 64-bit word.  That is 64 times smaller than an array
+ *  of points.  The end cell is kept as well, so steps are appended in
+ *  constant time.
+ *
+ *  A Maze Path file is a 32 byte header (magic, start row, start
+ *  column and step count as little-endian 64-bit values) followed by
+ *  the steps, 4 per byte, low bits first.
+ */
+typedef struct maze_path_st maze_path_t;
+
+/*
+ * Maze Path Iterator
+ *  Walks the cells of a Maze Path in order.  The fields are read-only:
+ *  `pos` is the current cell and `dir` is the step taken into it, which
+ *  is only valid after the first cell.
+ *
+ *    StartMazePathIter(&iter, path);
+ *    while (NextMazePathIter(&iter)) { ... iter.pos ... }
+ */
+typedef struct {
+  maze_path_t const *path;
+  size_t index;       /* Cells visited so far. */
+  point_t pos;
+  maze_dir_t dir;
+} maze_path_iter_t;
+
+/* - - Maze Path API - - */
+
+/* Maze Path constructor, a path of just the `start` cell. */
+maze_path_t *CreateMazePath(point_t const *start);
+/* Converts an array of `count` points.  Returns NULL if the array is
+ * empty or two consecutive points are not adjacent. */
+maze_path_t *CreateMazePathFromPoints(point_t const *points, size_t count);
+void FreeMazePath(maze_path_t *path);
+
+/* Number of cells in the path, the steps plus one. */
+size_t MazePathLength(maze_path_t const *path);
+void MazePathStart(maze_path_t const *path, point_t *start);
+void MazePathEnd(maze_path_t const *path, point_t *end);
+/* Direction of step `step`, from cell `step` to cell `step + 1`. */
+maze_dir_t GetMazePathStep(maze_path_t const *path, size_t step);
+
+/* Appends a step from the end cell.  Returns false if the step would
+ * leave the first row or column. */
+bool_t PushMazePathStep(maze_path_t *path, maze_dir_t dir);
+/* Reverses the path in place, the end becomes the start. */
+void ReverseMazePath(maze_path_t *path);
+
+/* Writes the cells to `points` with the same contract as the solvers:
+ * returns the length in cells, and only writes them if they fit in
+ * `max_points`. */
+size_t MazePathToPoints(
+  maze_path_t const *path, point_t *points, size_t max_points);
+
+/* - - Maze Path Iterator API - - */
+
+void StartMazePathIter(maze_path_iter_t *iter, maze_path_t const *path);
+/* Moves to the next cell.  Returns false once every cell was visited. */
+bool_t NextMazePathIter(maze_path_iter_t *iter);
+
+/* - - Maze Path Files - - */
+
+/* Returns false if the file cannot be written. */
+bool_t WriteMazePathFile(maze_path_t const *path, char const *filename);
+/* Returns NULL if the file cannot be read or is not a Maze Path file. */
+maze_path_t *ReadMazePathFile(char const *filename);
+
+#endif /* _MAZE_PATH_H_ */
@@ -0,0 +1,433 @@
+/*
+ * Mazart - Maze Solvers
+ *  Module provides breadth-first Maze solvers which report the exact
+ *  path length before the path is stored.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_solve.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Cell marks, one byte per cell.  The low 2 bits are the Maze
+ * Direction to the parent cell. */
+#define MARK_DIR 0x03
+#define MARK_ROOT 0x20
+#define MARK_DEST 0x40
+#define MARK_SRC 0x80
+#define MARK_SEEN (MARK_SRC | MARK_DEST)
+
+/* Initial capacity of the A* stacks, grows by doubling. */
+static size_t const kSolveStackSize = 64;
+
+/* - - Maze Solver Internal API - - */
+
+/* Growable stack of cell indices. */
+typedef struct {
+  size_t *items;
+  size_t size;
+  size_t capacity;
+} solve_stack_t;
+
+static void PushSolveStack(solve_stack_t *stack, size_t idx)
+{
+  if (stack->size == stack->capacity)
+  {
+    stack->capacity = stack->capacity ? 2 * stack->capacity : kSolveStackSize;
+    stack->items = (size_t*)realloc(
+      stack->items, stack->capacity * sizeof(size_t));
+  }
+  stack->items[stack->size++] = idx;
+}
+
+static inline size_t ManhattanDistance(
+  size_t idx, size_t width, point_t const *dest)
+{
+  size_t row, col;
+  row = idx / width;
+  col = idx % width;
+  return (row > dest->row ? row - dest->row : dest->row - row)
+    + (col > dest->col ? col - dest->col : dest->col - col);
+}
+
+static inline void IndexToPoint(size_t idx, size_t width, point_t *pos)
+{
+  pos->row = idx / width;
+  pos->col = idx % width;
+}
+
+/* Number of cells from `idx` up to and including its root. */
+static size_t CountMarkedDepth(uint8_t const *marks, size_t idx, size_t width)
+{
+  size_t depth;
+  depth = 1;
+  while (!(marks[idx] & MARK_ROOT))
+  {
+    idx = StepMazeIndex(idx, (maze_dir_t) (marks[idx] & MARK_DIR), width);
+    depth++;
+  }
+  return depth;
+}
+
+/* Writes the cells from `idx` to its root into path[first], path[first
+ * + step], ... */
+static void WriteMarkedPath(
+  uint8_t const *marks, size_t idx, size_t width,
+  point_t *path, size_t first, ptrdiff_t step)
+{
+  ptrdiff_t i;
+  i = (ptrdiff_t) first;
+  while (true)
+  {
+    IndexToPoint(idx, width, &path[i]);
+    if (marks[idx] & MARK_ROOT) break;
+    idx = StepMazeIndex(idx, (maze_dir_t) (marks[idx] & MARK_DIR), width);
+    i += step;
+  }
+}
+
+/* Appends the steps from `idx` to its root. */
+static void PushMarkedSteps(
+  uint8_t const *marks, size_t idx, size_t width, maze_path_t *path)
+{
+  maze_dir_t dir;
+  while (!(marks[idx] & MARK_ROOT))
+  {
+    dir = (maze_dir_t) (marks[idx] & MARK_DIR);
+    PushMazePathStep(path, dir);
+    idx = StepMazeIndex(idx, dir, width);
+  }
+}
+
+static inline void UpdateFrontier(maze_search_stats_t *stats, size_t frontier)
+{
+  if (frontier > stats->max_frontier) stats->max_frontier = frontier;
+}
+
+/* Breadth-first sweep from `src` over its whole component.  Returns
+ * the last cell reached, which is a farthest one, and sets `distance`
+ * to its steps from `src`. */
+static size_t SweepFarthest(
+  maze_conn_t const *conns, size_t width, size_t src,
+  uint8_t *marks, size_t *queue, size_t *distance)
+{
+  size_t head, tail, level_end, u, v, d;
+  head = tail = 0;
+  queue[tail++] = src;
+  marks[src] = MARK_SRC;
+  *distance = 0;
+  u = src;
+  for (level_end = tail; head < tail; level_end = tail, ++*distance)
+  {
+    while (head < level_end)
+    {
+      u = queue[head++];
+      for (d = 0; d < MAZE_DIR_COUNT; d++)
+      {
+        if (!(conns[u] & MazeDirToConn(d))) continue;
+        v = StepMazeIndex(u, (maze_dir_t) d, width);
+        if (marks[v]) continue;
+        marks[v] = MARK_SRC;
+        queue[tail++] = v;
+      }
+    }
+  }
+  /* The last level counted was empty. */
+  --*distance;
+  return u;
+}
+
+static bool_t IsSolvable(
+  maze_t const *maze, point_t const *src, point_t const *dest)
+{
+  if (!maze || !src || !dest) return false;
+  return GetMazeCell(maze, src) && GetMazeCell(maze, dest);
+}
+
+/* Searches from both ends at once, always expanding the smaller
+ * frontier by a whole level, until the searches meet.  Returns false
+ * if they never do.  Otherwise `marks` hold both search trees, and
+ * `meet_src` and `meet_dest` are the adjacent (or equal) cells where
+ * they met, `meet_dir` being the step between them. */
+static bool_t SearchBidirectional(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  uint8_t *marks, maze_search_stats_t *stats,
+  size_t *meet_src, size_t *meet_dest, maze_dir_t *meet_dir)
+{
+  maze_conn_t const *conns;
+  uint8_t side, other;
+  size_t *queue, width, count, u, v, d, level_end;
+  size_t src_head, src_tail, dest_head, dest_tail, *head, *tail;
+  bool_t met, from_src;
+  width = MazeWidth(maze);
+  count = MazeHeight(maze) * width;
+  conns = GetMazeConnections(maze);
+  /* A cell is only queued once, so both queues share one buffer: the
+   * source queue grows up from the front, the destination queue grows
+   * down from the back. */
+  queue = (size_t*)malloc(count * sizeof(size_t));
+  src_head = src_tail = 0;
+  dest_head = dest_tail = 0;
+  *meet_src = src->row * width + src->col;
+  *meet_dest = dest->row * width + dest->col;
+  *meet_dir = MAZE_DIR_UP;
+  queue[src_tail++] = *meet_src;
+  marks[*meet_src] = MARK_SRC | MARK_ROOT;
+  stats->visited = 1;
+  met = (*meet_src == *meet_dest);
+  if (!met)
+  {
+    queue[count - 1 - dest_tail++] = *meet_dest;
+    marks[*meet_dest] = MARK_DEST | MARK_ROOT;
+    stats->visited++;
+  }
+  while (!met && src_head < src_tail && dest_head < dest_tail)
+  {
+    from_src = (src_tail - src_head) <= (dest_tail - dest_head);
+    head = from_src ? &src_head : &dest_head;
+    tail = from_src ? &src_tail : &dest_tail;
+    side = from_src ? MARK_SRC : MARK_DEST;
+    other = from_src ? MARK_DEST : MARK_SRC;
+    for (level_end = *tail; !met && *head < level_end; )
+    {
+      u = from_src ? queue[(*head)++] : queue[count - 1 - (*head)++];
+      stats->expanded++;
+      for (d = 0; d < MAZE_DIR_COUNT; d++)
+      {
+        if (!(conns[u] & MazeDirToConn(d))) continue;
+        v = StepMazeIndex(u, (maze_dir_t) d, width);
+        if (marks[v] & other)
+        {
+          met = true;
+          *meet_src = from_src ? u : v;
+          *meet_dest = from_src ? v : u;
+          *meet_dir = from_src ? (maze_dir_t) d : OppositeMazeDir((maze_dir_t) d);
+          break;
+        }
+        if (marks[v]) continue;
+        marks[v] = side | OppositeMazeDir((maze_dir_t) d);
+        if (from_src) queue[(*tail)++] = v;
+        else queue[count - 1 - (*tail)++] = v;
+        stats->visited++;
+      }
+    }
+    UpdateFrontier(stats, (src_tail - src_head) + (dest_tail - dest_head));
+  }
+  free(queue);
+  return met;
+}
+
+/* - - Maze Solver API - - */
+
+size_t SolveMazeBfs(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  point_t *path, size_t max_path, maze_search_stats_t *stats)
+{
+  maze_search_stats_t local_stats;
+  maze_conn_t const *conns;
+  uint8_t *marks;
+  size_t *queue, head, tail, width, count, target, u, v, d, length;
+  if (!stats) stats = &local_stats;
+  memset(stats, 0, sizeof(maze_search_stats_t));
+  if (!IsSolvable(maze, src, dest)) return 0;
+  width = MazeWidth(maze);
+  count = MazeHeight(maze) * width;
+  conns = GetMazeConnections(maze);
+  marks = (uint8_t*)calloc(count, sizeof(uint8_t));
+  queue = (size_t*)malloc(count * sizeof(size_t));
+  target = dest->row * width + dest->col;
+  head = tail = 0;
+  queue[tail++] = src->row * width + src->col;
+  marks[queue[0]] = MARK_SRC | MARK_ROOT;
+  stats->visited = 1;
+  while (head < tail && !marks[target])
+  {
+    u = queue[head++];
+    stats->expanded++;
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      if (!(conns[u] & MazeDirToConn(d))) continue;
+      v = StepMazeIndex(u, (maze_dir_t) d, width);
+      if (marks[v]) continue;
+      marks[v] = MARK_SRC | OppositeMazeDir((maze_dir_t) d);
+      queue[tail++] = v;
+      stats->visited++;
+    }
+    UpdateFrontier(stats, tail - head);
+  }
+  length = 0;
+  if (marks[target])
+  {
+    length = CountMarkedDepth(marks, target, width);
+    if (path && length <= max_path)
+    {
+      WriteMarkedPath(marks, target, width, path, length - 1, -1);
+    }
+  }
+  free(queue);
+  free(marks);
+  return length;
+}
+
+size_t SolveMazeAStar(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  point_t *path, size_t max_path, maze_search_stats_t *stats)
+{
+  maze_search_stats_t local_stats;
+  maze_conn_t const *conns;
+  solve_stack_t current, next, swap;
+  uint8_t *marks;
+  size_t width, count, target, u, v, d, length, h;
+  if (!stats) stats = &local_stats;
+  memset(stats, 0, sizeof(maze_search_stats_t));
+  if (!IsSolvable(maze, src, dest)) return 0;
+  width = MazeWidth(maze);
+  count = MazeHeight(maze) * width;
+  conns = GetMazeConnections(maze);
+  marks = (uint8_t*)calloc(count, sizeof(uint8_t));
+  memset(&current, 0, sizeof(solve_stack_t));
+  memset(&next, 0, sizeof(solve_stack_t));
+  target = dest->row * width + dest->col;
+  u = src->row * width + src->col;
+  marks[u] = MARK_SRC | MARK_ROOT;
+  PushSolveStack(&current, u);
+  stats->visited = 1;
+  /* The estimate g + h of a neighbour is the same as its parent's when
+   * it is closer to `dest` (h - 1), and 2 more otherwise (h + 1).  The
+   * current stack is LIFO, so ties go deep first.  A perfect Maze has
+   * one path to each cell, so the search ends as soon as `dest` is
+   * reached. */
+  while (!marks[target])
+  {
+    if (current.size == 0)
+    {
+      if (next.size == 0) break;
+      swap = current;
+      current = next;
+      next = swap;
+    }
+    u = current.items[--current.size];
+    stats->expanded++;
+    h = ManhattanDistance(u, width, dest);
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      if (!(conns[u] & MazeDirToConn(d))) continue;
+      v = StepMazeIndex(u, (maze_dir_t) d, width);
+      if (marks[v]) continue;
+      marks[v] = MARK_SRC | OppositeMazeDir((maze_dir_t) d);
+      if (ManhattanDistance(v, width, dest) < h) PushSolveStack(&current, v);
+      else PushSolveStack(&next, v);
+      stats->visited++;
+    }
+    UpdateFrontier(stats, current.size + next.size);
+  }
+  length = 0;
+  if (marks[target])
+  {
+    length = CountMarkedDepth(marks, target, width);
+    if (path && length <= max_path)
+    {
+      WriteMarkedPath(marks, target, width, path, length - 1, -1);
+    }
+  }
+  free(current.items);
+  free(next.items);
+  free(marks);
+  return length;
+}
+
+size_t SolveMazeBidirectional(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  point_t *path, size_t max_path, maze_search_stats_t *stats)
+{
+  maze_search_stats_t local_stats;
+  uint8_t *marks;
+  size_t width, length, src_depth, meet_src, meet_dest;
+  maze_dir_t meet_dir;
+  if (!stats) stats = &local_stats;
+  memset(stats, 0, sizeof(maze_search_stats_t));
+  if (!IsSolvable(maze, src, dest)) return 0;
+  width = MazeWidth(maze);
+  marks = (uint8_t*)calloc(MazeHeight(maze) * width, sizeof(uint8_t));
+  length = 0;
+  if (SearchBidirectional(maze, src, dest, marks, stats,
+      &meet_src, &meet_dest, &meet_dir))
+  {
+    src_depth = CountMarkedDepth(marks, meet_src, width);
+    length = src_depth;
+    if (meet_src != meet_dest) length += CountMarkedDepth(marks, meet_dest, width);
+    if (path && length <= max_path)
+    {
+      WriteMarkedPath(marks, meet_src, width, path, src_depth - 1, -1);
+      if (meet_src != meet_dest)
+        WriteMarkedPath(marks, meet_dest, width, path, src_depth, 1);
+    }
+  }
+  free(marks);
+  return length;
+}
+
+maze_path_t *SolveMazePath(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  maze_search_stats_t *stats)
+{
+  maze_search_stats_t local_stats;
+  maze_path_t *path;
+  uint8_t *marks;
+  size_t width, meet_src, meet_dest;
+  maze_dir_t meet_dir;
+  point_t meet;
+  if (!stats) stats = &local_stats;
+  memset(stats, 0, sizeof(maze_search_stats_t));
+  if (!IsSolvable(maze, src, dest)) return NULL;
+  width = MazeWidth(maze);
+  marks = (uint8_t*)calloc(MazeHeight(maze) * width, sizeof(uint8_t));
+  path = NULL;
+  if (SearchBidirectional(maze, src, dest, marks, stats,
+      &meet_src, &meet_dest, &meet_dir))
+  {
+    /* Walk from the meeting cell back to `src`, then turn around and
+     * walk on to `dest`. */
+    IndexToPoint(meet_src, width, &meet);
+    path = CreateMazePath(&meet);
+    PushMarkedSteps(marks, meet_src, width, path);
+    ReverseMazePath(path);
+    if (meet_src != meet_dest)
+    {
+      PushMazePathStep(path, meet_dir);
+      PushMarkedSteps(marks, meet_dest, width, path);
+    }
+  }
+  free(marks);
+  return path;
+}
+
+size_t FindMazeDiameter(maze_t const *maze, point_t *a, point_t *b)
+{
+  maze_conn_t const *conns;
+  uint8_t *marks;
+  size_t *queue, width, count, start, u, v, distance;
+  point_t pos;
+  if (!maze) return 0;
+  width = MazeWidth(maze);
+  count = MazeHeight(maze) * width;
+  if (count == 0) return 0;
+  conns = GetMazeConnections(maze);
+  marks = (uint8_t*)calloc(count, sizeof(uint8_t));
+  queue = (size_t*)malloc(count * sizeof(size_t));
+  MazeStart(maze, &pos);
+  start = pos.row * width + pos.col;
+  /* In a tree, a farthest cell from any cell is an end of a longest
+   * path, and a farthest cell from it is the other end. */
+  u = SweepFarthest(conns, width, start, marks, queue, &distance);
+  memset(marks, 0, count * sizeof(uint8_t));
+  v = SweepFarthest(conns, width, u, marks, queue, &distance);
+  if (a) IndexToPoint(u, width, a);
+  if (b) IndexToPoint(v, width, b);
+  free(queue);
+  free(marks);
+  return distance;
+}
@@ -0,0 +1,72 @@
+/*
+ * Mazart - Maze Solvers
+ *  Module provides breadth-first Maze solvers which report the exact
+ *  path length before the path is stored.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_SOLVE_H_
+#define _MAZE_SOLVE_H_
+
+#include "common.h"
+#include "maze.h"
+#include "maze_path.h"
+
+/*
+ * Maze Search Stats Struct
+ *  Counters describing the work done by a solver, so solvers can be
+ *  compared on the same Maze.
+ */
+typedef struct {
+  size_t visited;       /* Cells reached by the search. */
+  size_t expanded;      /* Cells whose connections were followed. */
+  size_t max_frontier;  /* Largest number of reached, unexpanded cells. */
+} maze_search_stats_t;
+
+/* - - Maze Solver API - - */
+
+/* Finds the shortest path from `src` to `dest` with a breadth-first
+ * search.  Returns the path length in cells (1 if `src` and `dest` are
+ * the same), or 0 if there is no path.  The path, `src` to `dest`, is
+ * written to `path` only if it fits in `max_path` points, so the
+ * solver can be called with a NULL path to learn the length first.
+ * `stats` is optional. */
+size_t SolveMazeBfs(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  point_t *path, size_t max_path, maze_search_stats_t *stats);
+
+/* Same as SolveMazeBfs(), but searches from both ends at once, always
+ * expanding the smaller frontier by a whole level, and stops when the
+ * two searches meet.  Reaches far fewer cells when the ends are close. */
+size_t SolveMazeBidirectional(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  point_t *path, size_t max_path, maze_search_stats_t *stats);
+
+/* Same as SolveMazeBfs(), but an A* search guided by the Manhattan
+ * distance to `dest`.  Each step changes the estimate by 0 or 2, so the
+ * open set is a bucket queue of just two stacks: the current estimate
+ * and the next one.  The search state grows with the cells expanded,
+ * apart from one mark byte per cell. */
+size_t SolveMazeAStar(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  point_t *path, size_t max_path, maze_search_stats_t *stats);
+
+/* Same search as SolveMazeBidirectional(), but returns the path as a
+ * compact Maze Path, which is built without an array of points.
+ * Returns NULL if there is no path. */
+maze_path_t *SolveMazePath(
+  maze_t const *maze, point_t const *src, point_t const *dest,
+  maze_search_stats_t *stats);
+
+/* - - Maze Diameter - - */
+
+/* Finds the two cells with the longest path between them, with two
+ * breadth-first sweeps: from the Maze start to a farthest cell `a`,
+ * then from `a` to a farthest cell `b`.  Returns the steps between
+ * them.  Exact for a perfect Maze; with loops, `a` and `b` are only far
+ * apart.  Only cells connected to the start are considered. */
+size_t FindMazeDiameter(maze_t const *maze, point_t *a, point_t *b);
+
+#endif /* _MAZE_SOLVE_H_ */
@@ -0,0 +1,120 @@
+/*
+ * Mazart - Maze Statistics
+ *  Module counts structural statistics of a Maze, such as dead ends,
+ *  junctions, corridor lengths and turns, for grading Mazes.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_stats.h"
+
+#include <string.h>
+
+#define CELLS_PER_WORD 8
+/* Lowest bit of every cell's connection byte. */
+#define CELL_BITS 0x0101010101010101ULL
+
+/* - - Maze Statistics Internal API - - */
+
+/* Counts degrees, passages and 2-passage shapes, 8 cells per word.
+ * Bit-plane `a` holds every cell's up bit, `b` down, `c` left and `d`
+ * right, each at the lowest bit of the cell's byte. */
+static void CountCellShapes(maze_conn_t const *conns, size_t count, maze_stats_t *stats)
+{
+  uint64_t word, a, b, c, d, ab_sum, ab_carry, cd_sum, cd_carry, ones, twos, fours;
+  size_t i, n, reached;
+  reached = 0;
+  for (i = 0; i < count; i += CELLS_PER_WORD)
+  {
+    n = count - i < CELLS_PER_WORD ? count - i : CELLS_PER_WORD;
+    word = 0;
+    memcpy(&word, &conns[i], n);
+    a = (word >> MAZE_DIR_UP) & CELL_BITS;
+    b = (word >> MAZE_DIR_DOWN) & CELL_BITS;
+    c = (word >> MAZE_DIR_LEFT) & CELL_BITS;
+    d = (word >> MAZE_DIR_RIGHT) & CELL_BITS;
+    /* Degree = a + b + c + d, as bits of 1, 2 and 4. */
+    ab_sum = a ^ b;
+    ab_carry = a & b;
+    cd_sum = c ^ d;
+    cd_carry = c & d;
+    ones = ab_sum ^ cd_sum;
+    twos = ab_carry ^ cd_carry ^ (ab_sum & cd_sum);
+    fours = ab_carry & cd_carry;
+    stats->degrees[1] += (size_t) __builtin_popcountll(ones & ~twos);
+    stats->degrees[2] += (size_t) __builtin_popcountll(twos & ~ones);
+    stats->degrees[3] += (size_t) __builtin_popcountll(ones & twos);
+    stats->degrees[4] += (size_t) __builtin_popcountll(fours);
+    stats->straights += (size_t) __builtin_popcountll(
+      (ab_carry & ~(c | d)) | (cd_carry & ~(a | b)));
+    /* Each passage is counted at the cell below or left of it. */
+    stats->passages += (size_t) (__builtin_popcountll(a) + __builtin_popcountll(d));
+  }
+  for (i = 1; i <= MAZE_DIR_COUNT; i++) reached += stats->degrees[i];
+  stats->degrees[0] = count - reached;
+  stats->turns = stats->degrees[2] - stats->straights;
+}
+
+/* Follows the corridor leaving cell `from` in `dir` to its other end.
+ * Sets `end` and `end_dir`, the direction the end is left in to walk
+ * back.  Returns the corridor's steps. */
+static size_t WalkCorridor(
+  maze_conn_t const *conns, size_t width, size_t from, maze_dir_t dir,
+  size_t *end, maze_dir_t *end_dir)
+{
+  maze_conn_t out;
+  size_t cell, steps;
+  cell = StepMazeIndex(from, dir, width);
+  steps = 1;
+  while (__builtin_popcount(conns[cell]) == 2)
+  {
+    out = conns[cell] & (maze_conn_t) ~MazeDirToConn(OppositeMazeDir(dir));
+    dir = (maze_dir_t) __builtin_ctz(out);
+    cell = StepMazeIndex(cell, dir, width);
+    steps++;
+  }
+  *end = cell;
+  *end_dir = OppositeMazeDir(dir);
+  return steps;
+}
+
+/* Walks every corridor from its ends, counting each once, from the end
+ * with the lower index (or direction, for a corridor back to itself). */
+static void CountCorridors(
+  maze_conn_t const *conns, size_t count, size_t width, maze_stats_t *stats)
+{
+  maze_dir_t end_dir;
+  size_t cell, end, d, steps, bucket;
+  for (cell = 0; cell < count; cell++)
+  {
+    if (conns[cell] == 0 || __builtin_popcount(conns[cell]) == 2) continue;
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      if (!(conns[cell] & MazeDirToConn(d))) continue;
+      steps = WalkCorridor(conns, width, cell, (maze_dir_t) d, &end, &end_dir);
+      if (end < cell || (end == cell && (size_t) end_dir < d)) continue;
+      bucket = (size_t) (63 - __builtin_clzll((unsigned long long) steps));
+      if (bucket >= MAZE_STATS_CORRIDOR_BUCKETS) bucket = MAZE_STATS_CORRIDOR_BUCKETS - 1;
+      stats->corridors++;
+      stats->corridor_lengths[bucket]++;
+      if (steps > stats->longest_corridor) stats->longest_corridor = steps;
+    }
+  }
+}
+
+/* - - Maze Statistics API - - */
+
+bool_t FindMazeStats(
+  maze_t const *maze, maze_path_t const *path, maze_stats_t *stats)
+{
+  maze_conn_t const *conns;
+  if (!maze || !stats) return false;
+  memset(stats, 0, sizeof(maze_stats_t));
+  conns = GetMazeConnections(maze);
+  stats->cells = MazeHeight(maze) * MazeWidth(maze);
+  CountCellShapes(conns, stats->cells, stats);
+  CountCorridors(conns, stats->cells, MazeWidth(maze), stats);
+  stats->solution_length = path ? MazePathLength(path) : 0;
+  return true;
+}
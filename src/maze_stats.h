@@ -0,0 +1,58 @@
+/*
+ * Mazart - Maze Statistics
+ *  Module counts structural statistics of a Maze, such as dead ends,
+ *  junctions, corridor lengths and turns, for grading Mazes.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_STATS_H_
+#define _MAZE_STATS_H_
+
+#include "common.h"
+#include "maze.h"
+#include "maze_path.h"
+
+/* Number of corridor length buckets, bucket k counts the corridors of
+ * 2^k to 2^(k+1) - 1 steps. */
+#define MAZE_STATS_CORRIDOR_BUCKETS 32
+
+/*
+ * Maze Statistics
+ *  The cell counts come from one pass over the Maze connections, 8
+ *  cells per word: the 4 direction bits of every cell are summed as
+ *  bit-planes, and each degree, and each shape of 2-passage cell, is a
+ *  mask whose set bits are counted with popcount.
+ *
+ *  A corridor is a run of passages whose inner cells have exactly 2
+ *  passages; it ends at dead ends and junctions.  Corridors are walked
+ *  from their ends, so each passage is stepped at most twice.  A loop
+ *  of 2-passage cells that touches no junction has no end and is not
+ *  counted.
+ */
+typedef struct {
+  size_t cells;
+  /* Connected pairs of adjacent cells. */
+  size_t passages;
+  /* Cells by number of passages: 0 is closed off, 1 a dead end, 3 and
+   * 4 junctions. */
+  size_t degrees[MAZE_DIR_COUNT + 1];
+  /* Cells with 2 passages that go straight through, or turn. */
+  size_t straights;
+  size_t turns;
+  size_t corridors;
+  size_t longest_corridor;
+  size_t corridor_lengths[MAZE_STATS_CORRIDOR_BUCKETS];
+  /* Cells of the solution path, or 0 if there is none. */
+  size_t solution_length;
+} maze_stats_t;
+
+/* - - Maze Statistics API - - */
+
+/* Counts the statistics of `maze` into `stats`.  `path` is the solution
+ * path, which may be NULL.  Returns false if the Maze is NULL. */
+bool_t FindMazeStats(
+  maze_t const *maze, maze_path_t const *path, maze_stats_t *stats);
+
+#endif /* _MAZE_STATS_H_ */
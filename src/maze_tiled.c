@@ -0,0 +1,179 @@
+/*
+ * Mazart - Tiled Maze Generator
+ *  Module provides tile-parallel Maze generation.  The Maze is split
+ *  into tiles, each tile is drawn by any Maze algorithm on its own
+ *  thread, and the tiles are then stitched into one perfect Maze.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_tiled.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rng.h"
+#include "thread_pool.h"
+
+/* - - Maze Tile Structure - - */
+
+typedef struct {
+  maze_conn_t *conns;
+  size_t stride;       /* Maze width. */
+  point_t corner;      /* Lowest row and column of the tile. */
+  size_t height;
+  size_t width;
+  maze_algorithm_t algorithm;
+  uint64_t seed;
+} maze_tile_t;
+
+/* Boundary between two adjacent tiles, `a` is the lower tile index. */
+typedef struct {
+  size_t a;
+  size_t b;
+} maze_tile_edge_t;
+
+/* - - Maze Tile Internal API - - */
+
+/* Draws the tile as its own Maze and copies it into the full Maze.
+ * Tiles do not overlap, so no locking is needed. */
+static void DrawMazeTile(void *vtile)
+{
+  maze_tile_t *tile;
+  maze_t *tile_maze;
+  maze_conn_t const *tile_conns;
+  point_t start;
+  rng_t rng;
+  size_t row;
+  tile = vtile;
+  SeedRng(&rng, tile->seed);
+  start.row = NextRngBelow(&rng, tile->height);
+  start.col = NextRngBelow(&rng, tile->width);
+  tile_maze = CreateSeededMaze(tile->height, tile->width,
+    &start, &start, tile->algorithm, NextRng(&rng));
+  if (!tile_maze) return;
+  tile_conns = GetMazeConnections(tile_maze);
+  for (row = 0; row < tile->height; row++)
+  {
+    memcpy(
+      &tile->conns[(tile->corner.row + row) * tile->stride + tile->corner.col],
+      &tile_conns[row * tile->width],
+      tile->width * sizeof(maze_conn_t));
+  }
+  FreeMaze(tile_maze);
+}
+
+static size_t FindMazeTileSet(size_t *parent, size_t tile)
+{
+  while (parent[tile] != tile)
+  {
+    parent[tile] = parent[parent[tile]];
+    tile = parent[tile];
+  }
+  return tile;
+}
+
+/* Opens one random passage across the boundary of two adjacent tiles. */
+static void StitchMazeTiles(
+  maze_tile_t const *a, maze_tile_t const *b, rng_t *rng)
+{
+  point_t pos;
+  size_t idx;
+  if (a->corner.row == b->corner.row)
+  {
+    /* Side by side, `b` is to the right. */
+    pos.row = a->corner.row + NextRngBelow(rng, a->height);
+    pos.col = b->corner.col - 1;
+    idx = pos.row * a->stride + pos.col;
+    a->conns[idx] |= MAZE_CONN_RIGHT;
+    a->conns[idx + 1] |= MAZE_CONN_LEFT;
+  }
+  else
+  {
+    /* Stacked, `b` is the next row. */
+    pos.row = b->corner.row - 1;
+    pos.col = a->corner.col + NextRngBelow(rng, a->width);
+    idx = pos.row * a->stride + pos.col;
+    a->conns[idx] |= MAZE_CONN_UP;
+    a->conns[idx + a->stride] |= MAZE_CONN_DOWN;
+  }
+}
+
+/* - - Tiled Maze API - - */
+
+void DrawTiledMaze(maze_t *maze, maze_algorithm_t algorithm, size_t tiles)
+{
+  maze_tile_t *tile_list;
+  maze_tile_edge_t *edges, edge;
+  thread_pool_t *pool;
+  rng_t rng;
+  size_t height, width, count, edge_count, i, j, k, *parent;
+  if (!maze || tiles == 0) return;
+  height = MazeHeight(maze);
+  width = MazeWidth(maze);
+  if (tiles > height) tiles = height;
+  if (tiles > width) tiles = width;
+  count = tiles * tiles;
+  SplitMazeRng(maze, &rng);
+
+  /* Draw every tile. */
+  tile_list = (maze_tile_t*)calloc(count, sizeof(maze_tile_t));
+  pool = CreateThreadPool(0);
+  for (i = 0; i < tiles; i++)
+  {
+    for (j = 0; j < tiles; j++)
+    {
+      maze_tile_t *tile;
+      tile = &tile_list[i * tiles + j];
+      tile->conns = GetMazeConnectionsMutable(maze);
+      tile->stride = width;
+      tile->corner.row = (i * height) / tiles;
+      tile->corner.col = (j * width) / tiles;
+      tile->height = ((i + 1) * height) / tiles - tile->corner.row;
+      tile->width = ((j + 1) * width) / tiles - tile->corner.col;
+      tile->algorithm = algorithm;
+      tile->seed = NextRng(&rng);
+      if (!pool || !SubmitThreadTask(pool, DrawMazeTile, tile))
+      {
+        DrawMazeTile(tile);
+      }
+    }
+  }
+  WaitThreadPool(pool);
+  FreeThreadPool(pool);
+
+  /* Join the tiles along a random spanning tree of the tile grid
+   * (randomized Kruskal's algorithm). */
+  edge_count = 0;
+  edges = (maze_tile_edge_t*)calloc(2 * count, sizeof(maze_tile_edge_t));
+  for (i = 0; i < tiles; i++)
+  {
+    for (j = 0; j < tiles; j++)
+    {
+      k = i * tiles + j;
+      if ((j + 1) < tiles) edges[edge_count++] = (maze_tile_edge_t) {k, k + 1};
+      if ((i + 1) < tiles) edges[edge_count++] = (maze_tile_edge_t) {k, k + tiles};
+    }
+  }
+  for (i = edge_count; i > 1; i--)
+  {
+    j = NextRngBelow(&rng, i);
+    edge = edges[i - 1];
+    edges[i - 1] = edges[j];
+    edges[j] = edge;
+  }
+  parent = (size_t*)calloc(count, sizeof(size_t));
+  for (k = 0; k < count; k++) parent[k] = k;
+  for (i = 0; i < edge_count; i++)
+  {
+    j = FindMazeTileSet(parent, edges[i].a);
+    k = FindMazeTileSet(parent, edges[i].b);
+    if (j == k) continue;
+    parent[k] = j;
+    StitchMazeTiles(&tile_list[edges[i].a], &tile_list[edges[i].b], &rng);
+  }
+  free(parent);
+  free(edges);
+  free(tile_list);
+}
@@ -0,0 +1,26 @@
+/*
+ * Mazart - Tiled Maze Generator
+ *  Module provides tile-parallel Maze generation.  The Maze is split
+ *  into tiles, each tile is drawn by any Maze algorithm on its own
+ *  thread, and the tiles are then stitched into one perfect Maze.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_TILED_H_
+#define _MAZE_TILED_H_
+
+#include "common.h"
+#include "maze.h"
+
+/* Draws the Maze's connections as `tiles` x `tiles` tiles (fewer if the
+ * Maze is too small).  Each tile is drawn as a seeded Maze using
+ * `algorithm`, with its own random stream, on a Thread Pool worker.
+ * The tiles are joined along a random spanning tree of the tile grid,
+ * opening exactly one random passage per tree edge, so the result is
+ * still a perfect Maze.  The Maze connections are expected to be
+ * cleared. */
+void DrawTiledMaze(maze_t *maze, maze_algorithm_t algorithm, size_t tiles);
+
+#endif /* _MAZE_TILED_H_ */
@@ -0,0 +1,211 @@
+/*
+ * Mazart - Maze Tree Metrics
+ *  Module fills cell properties with metrics of the Maze as a tree
+ *  rooted at one cell, such as subtree sizes and eccentricities.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_tree.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Parent of a cell that has not been reached. */
+#define TREE_UNSEEN UINT32_MAX
+
+/* - - Maze Tree Structures - - */
+
+typedef struct {
+  size_t height;
+  size_t width;
+  size_t count;
+  size_t reached;
+  uint32_t *order;      /* Cells reached, breadth-first. */
+  uint32_t *parent;     /* Parent cell, the root is its own. */
+  uint32_t *size;       /* Subtree size. */
+  uint32_t *down;       /* Longest branch below. */
+  uint32_t *down2;      /* Longest branch below through another child. */
+  uint32_t *best;       /* Child of the longest branch below. */
+  uint32_t *up;         /* Longest way out through the parent. */
+  uint64_t *squares;    /* Sum of squared child subtree sizes, or NULL. */
+} maze_tree_t;
+
+/* - - Maze Tree Internal API - - */
+
+static void FreeTreeArrays(maze_tree_t *tree)
+{
+  free(tree->order);
+  free(tree->parent);
+  free(tree->size);
+  free(tree->down);
+  free(tree->down2);
+  free(tree->best);
+  free(tree->up);
+  free(tree->squares);
+}
+
+/* Orders the cells reached from `root` breadth-first. */
+static void OrderTree(maze_tree_t *tree, maze_conn_t const *conns, size_t root)
+{
+  maze_conn_t c;
+  size_t head, u, v, d;
+  memset(tree->parent, 0xFF, tree->count * sizeof(uint32_t));
+  tree->parent[root] = (uint32_t) root;
+  tree->order[0] = (uint32_t) root;
+  tree->reached = 1;
+  for (head = 0; head < tree->reached; head++)
+  {
+    u = tree->order[head];
+    c = conns[u];
+    for (d = 0; d < MAZE_DIR_COUNT; d++)
+    {
+      if (!(c & MazeDirToConn(d))) continue;
+      v = StepMazeIndex(u, (maze_dir_t) d, tree->width);
+      if (tree->parent[v] != TREE_UNSEEN) continue;
+      tree->parent[v] = (uint32_t) u;
+      tree->order[tree->reached++] = (uint32_t) v;
+    }
+  }
+}
+
+/* Up the order: a cell's subtree and branches are complete before it
+ * is added to its parent. */
+static void GatherTree(maze_tree_t *tree)
+{
+  uint32_t v, p, h;
+  size_t i;
+  for (i = 0; i < tree->reached; i++)
+  {
+    v = tree->order[i];
+    tree->size[v] = 1;
+    tree->down[v] = tree->down2[v] = 0;
+    tree->best[v] = TREE_UNSEEN;
+    if (tree->squares) tree->squares[v] = 0;
+  }
+  for (i = tree->reached; i-- > 1; )
+  {
+    v = tree->order[i];
+    p = tree->parent[v];
+    tree->size[p] += tree->size[v];
+    if (tree->squares) tree->squares[p] += (uint64_t) tree->size[v] * tree->size[v];
+    h = tree->down[v] + 1;
+    if (h > tree->down[p])
+    {
+      tree->down2[p] = tree->down[p];
+      tree->down[p] = h;
+      tree->best[p] = v;
+    }
+    else if (h > tree->down2[p])
+    {
+      tree->down2[p] = h;
+    }
+  }
+}
+
+/* Down the order: the longest way out of a cell through its parent
+ * either goes on through the parent's parent, or down another of the
+ * parent's branches. */
+static void RerootTree(maze_tree_t *tree)
+{
+  uint32_t v, p, other;
+  size_t i;
+  tree->up[tree->order[0]] = 0;
+  for (i = 1; i < tree->reached; i++)
+  {
+    v = tree->order[i];
+    p = tree->parent[v];
+    other = tree->best[p] == v ? tree->down2[p] : tree->down[p];
+    tree->up[v] = 1 + (tree->up[p] > other ? tree->up[p] : other);
+  }
+}
+
+/* Traffic of cell `v`, in a tree of `tree->reached` cells. */
+static int64_t TreeTraffic(maze_tree_t const *tree, uint32_t v)
+{
+  uint64_t others, rest, pairs;
+  others = tree->reached - 1;
+  rest = tree->reached - tree->size[v];
+  /* Pairs ending at `v`, then pairs with ends in two different parts. */
+  pairs = others + (others * others - tree->squares[v] - rest * rest) / 2;
+  return (int64_t) llround(MAZE_TREE_TRAFFIC_SCALE * log2(1.0 + (double) pairs));
+}
+
+/* - - Maze Tree Metrics API - - */
+
+bool_t FillMazeTreeMetrics(
+  maze_t const *maze, maze_tree_request_t const *request,
+  int64_t maxes[MAZE_TREE_METRIC_COUNT])
+{
+  maze_tree_t tree;
+  maze_cell_t *cell;
+  point_t pos;
+  int64_t scratch[MAZE_TREE_METRIC_COUNT];
+  int64_t values[MAZE_TREE_METRIC_COUNT];
+  uint8_t metrics;
+  size_t idx, m;
+  if (!maxes) maxes = scratch;
+  for (m = 0; m < MAZE_TREE_METRIC_COUNT; m++) maxes[m] = -1;
+  if (!maze || !request) return false;
+  memset(&tree, 0, sizeof(maze_tree_t));
+  tree.height = MazeHeight(maze);
+  tree.width = MazeWidth(maze);
+  tree.count = tree.height * tree.width;
+  if (request->root.row >= tree.height || request->root.col >= tree.width) return false;
+  if (tree.count >= TREE_UNSEEN) return false;
+  metrics = request->metrics & MAZE_TREE_ALL_METRICS;
+  tree.order = (uint32_t*)malloc(tree.count * sizeof(uint32_t));
+  tree.parent = (uint32_t*)malloc(tree.count * sizeof(uint32_t));
+  tree.size = (uint32_t*)malloc(tree.count * sizeof(uint32_t));
+  tree.down = (uint32_t*)malloc(tree.count * sizeof(uint32_t));
+  tree.down2 = (uint32_t*)malloc(tree.count * sizeof(uint32_t));
+  tree.best = (uint32_t*)malloc(tree.count * sizeof(uint32_t));
+  tree.up = (uint32_t*)malloc(tree.count * sizeof(uint32_t));
+  if (metrics & MazeTreeMetricMask(MAZE_TREE_TRAFFIC))
+    tree.squares = (uint64_t*)malloc(tree.count * sizeof(uint64_t));
+  OrderTree(&tree, GetMazeConnections(maze),
+    request->root.row * tree.width + request->root.col);
+  GatherTree(&tree);
+  if (metrics & MazeTreeMetricMask(MAZE_TREE_ECCENTRICITY)) RerootTree(&tree);
+  for (m = 0; m < MAZE_TREE_METRIC_COUNT; m++)
+  {
+    if (metrics & MazeTreeMetricMask(m)) maxes[m] = 0;
+  }
+  idx = 0;
+  for (pos.row = 0; pos.row < tree.height; pos.row++)
+  for (pos.col = 0; pos.col < tree.width; pos.col++, idx++)
+  {
+    cell = GetMazeCell(maze, &pos);
+    if (!cell) continue;
+    if (tree.parent[idx] == TREE_UNSEEN)
+    {
+      values[MAZE_TREE_SUBTREE] = 0;
+      values[MAZE_TREE_BRANCH] = 0;
+      values[MAZE_TREE_ECCENTRICITY] = 0;
+      values[MAZE_TREE_TRAFFIC] = 0;
+    }
+    else
+    {
+      values[MAZE_TREE_SUBTREE] = tree.size[idx];
+      values[MAZE_TREE_BRANCH] = (int64_t) tree.down[idx] + 1;
+      values[MAZE_TREE_ECCENTRICITY] = 0;
+      if (metrics & MazeTreeMetricMask(MAZE_TREE_ECCENTRICITY))
+      {
+        values[MAZE_TREE_ECCENTRICITY] = 1 + (int64_t)
+          (tree.down[idx] > tree.up[idx] ? tree.down[idx] : tree.up[idx]);
+      }
+      values[MAZE_TREE_TRAFFIC] = 0;
+      if (tree.squares) values[MAZE_TREE_TRAFFIC] = TreeTraffic(&tree, (uint32_t) idx);
+    }
+    for (m = 0; m < MAZE_TREE_METRIC_COUNT; m++)
+    {
+      if (!(metrics & MazeTreeMetricMask(m))) continue;
+      SetMazeCellProperty(cell, request->properties[m], values[m]);
+      if (values[m] > maxes[m]) maxes[m] = values[m];
+    }
+  }
+  FreeTreeArrays(&tree);
+  return true;
+}
@@ -0,0 +1,80 @@
+/*
+ * Mazart - Maze Tree Metrics
+ *  Module fills cell properties with metrics of the Maze as a tree
+ *  rooted at one cell, such as subtree sizes and eccentricities.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_TREE_H_
+#define _MAZE_TREE_H_
+
+#include "common.h"
+#include "maze.h"
+
+/*
+ * Maze Tree Metrics
+ *  The cells reached from the root are ordered breadth-first, which
+ *  gives every cell its parent.  One pass up the order, from the
+ *  deepest cells, sums subtree sizes and keeps the two longest branches
+ *  below each cell; one pass down the order then reroots, giving each
+ *  cell the longest way out through its parent.  Naively, eccentricity
+ *  alone would take a search from every cell, and traffic a search
+ *  between every pair of cells.
+ *
+ *  A perfect Maze is a tree.  A Maze with loops is measured as its
+ *  breadth-first spanning tree.  Metrics are 0 for cells that cannot
+ *  be reached from the root.
+ */
+typedef enum {
+  /* Number of cells in the subtree hanging off the cell, itself
+   * included. */
+  MAZE_TREE_SUBTREE,
+  /* One more than the steps from the cell to the deepest cell of its
+   * subtree, so 1 for a dead end. */
+  MAZE_TREE_BRANCH,
+  /* One more than the steps from the cell to the cell furthest from
+   * it anywhere in the tree. */
+  MAZE_TREE_ECCENTRICITY,
+  /* Traffic: how many pairs of cells have their path through the cell,
+   * counting the pairs it ends.  Removing the cell splits the tree into
+   * its child subtrees and the rest, and a pair passes through it when
+   * its ends are in different parts, which the subtree sizes count.
+   * Counts grow with the square of the Maze size, so the value stored
+   * is MAZE_TREE_TRAFFIC_SCALE times the log2 of one more than the
+   * count, rounded. */
+  MAZE_TREE_TRAFFIC,
+  MAZE_TREE_METRIC_COUNT
+} maze_tree_metric_t;
+
+/* Maze Tree Metric to its bit in a metric mask. */
+#define MazeTreeMetricMask(m) ((uint8_t) (1 << (m)))
+#define MAZE_TREE_ALL_METRICS \
+  (MazeTreeMetricMask(MAZE_TREE_SUBTREE) \
+    | MazeTreeMetricMask(MAZE_TREE_BRANCH) \
+    | MazeTreeMetricMask(MAZE_TREE_ECCENTRICITY) \
+    | MazeTreeMetricMask(MAZE_TREE_TRAFFIC))
+
+/* Fixed-point steps per doubling of the traffic count. */
+#define MAZE_TREE_TRAFFIC_SCALE 256
+
+typedef struct {
+  /* Mask of the metrics to fill. */
+  uint8_t metrics;
+  /* Cell property each metric is stored in. */
+  maze_property_t properties[MAZE_TREE_METRIC_COUNT];
+  /* Root of the tree, such as the Maze start. */
+  point_t root;
+} maze_tree_request_t;
+
+/* - - Maze Tree Metrics API - - */
+
+/* Fills the requested metrics of `maze`.  Sets `maxes`, if not NULL,
+ * to the largest value of each metric, or -1 for metrics that were not
+ * requested.  Returns false if the root is outside the Maze. */
+bool_t FillMazeTreeMetrics(
+  maze_t const *maze, maze_tree_request_t const *request,
+  int64_t maxes[MAZE_TREE_METRIC_COUNT]);
+
+#endif /* _MAZE_TREE_H_ */
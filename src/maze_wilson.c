@@ -0,0 +1,160 @@
+/*
+ * Mazart - Wilson's Maze Generator
+ *  Module provides a Maze generator using Wilson's algorithm.  Mazes
+ *  are sampled uniformly from all spanning trees of the Maze grid.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_wilson.h"
+
+#include <stdlib.h>
+
+/* - - Walk Byte Layout - - */
+
+/* Cell has been added to the spanning tree. */
+static uint8_t const kWilsonInTree = 0x80;
+/* Lower 2 bits hold the last direction the walk left the cell in.
+ * Overwriting it when a walk revisits a cell erases the loop. */
+static uint8_t const kWilsonDirMask = 0x03;
+
+/* - - Wilson Internal API - - */
+
+/* Picks a random direction that stays within the Maze. */
+static maze_dir_t RandomWilsonDir(
+  maze_t *maze, point_t const *pos, size_t height, size_t width)
+{
+  maze_dir_t dir;
+  point_t next;
+  do
+  {
+    dir = (maze_dir_t) (NextMazeRandom(maze) & 0x3);
+    next = *pos;
+  }
+  while (!StepMazePoint(&next, dir, height, width));
+  return dir;
+}
+
+/* - - Wilson Generator Structure - - */
+
+struct wilson_gen_st {
+  maze_t *maze;
+  maze_conn_t *conns;
+  uint8_t *walk;
+  size_t height;
+  size_t width;
+  size_t idx;          /* First cell of the current walk. */
+  size_t cur;          /* Head of the current walk. */
+  point_t pos;
+  bool_t walking;      /* A walk has started. */
+  bool_t retracing;    /* The walk hit the tree and is being added. */
+  bool_t done;
+};
+
+/* - - Wilson API - - */
+
+wilson_gen_t *CreateWilsonGenerator(maze_t *maze)
+{
+  wilson_gen_t *gen;
+  point_t start;
+  if (!maze) return NULL;
+  gen = (wilson_gen_t*)calloc(1, sizeof(wilson_gen_t));
+  gen->maze = maze;
+  gen->conns = GetMazeConnectionsMutable(maze);
+  gen->height = MazeHeight(maze);
+  gen->width = MazeWidth(maze);
+  gen->walk = (uint8_t*)calloc(gen->height * gen->width, sizeof(uint8_t));
+  MazeStart(maze, &start);
+  gen->walk[start.row * gen->width + start.col] = kWilsonInTree;
+  return gen;
+}
+
+void FreeWilsonGenerator(wilson_gen_t *gen)
+{
+  if (!gen) return;
+  free(gen->walk);
+  free(gen);
+}
+
+size_t StepWilsonGenerator(wilson_gen_t *gen, size_t max_work)
+{
+  point_t next;
+  size_t work, edges, nidx;
+  maze_dir_t dir;
+  if (!gen) return 0;
+  work = edges = 0;
+  for (; !gen->done && work < max_work; work++)
+  {
+    if (!gen->walking)
+    {
+      /* Next cell that is not in the tree starts a walk. */
+      if (gen->idx == gen->height * gen->width)
+      {
+        gen->done = true;
+        break;
+      }
+      if (gen->walk[gen->idx] & kWilsonInTree)
+      {
+        gen->idx++;
+        continue;
+      }
+      gen->pos.row = gen->idx / gen->width;
+      gen->pos.col = gen->idx % gen->width;
+      gen->cur = gen->idx;
+      gen->walking = true;
+      gen->retracing = false;
+    }
+    else if (!gen->retracing)
+    {
+      /* Random walk until the tree is hit, recording exit directions. */
+      if (gen->walk[gen->cur] & kWilsonInTree)
+      {
+        gen->pos.row = gen->idx / gen->width;
+        gen->pos.col = gen->idx % gen->width;
+        gen->cur = gen->idx;
+        gen->retracing = true;
+        continue;
+      }
+      dir = RandomWilsonDir(gen->maze, &gen->pos, gen->height, gen->width);
+      gen->walk[gen->cur] = (uint8_t) dir;
+      StepMazePoint(&gen->pos, dir, gen->height, gen->width);
+      gen->cur = gen->pos.row * gen->width + gen->pos.col;
+    }
+    else
+    {
+      /* Retrace the loop-erased walk, adding it to the tree. */
+      if (gen->walk[gen->cur] & kWilsonInTree)
+      {
+        gen->walking = false;
+        gen->idx++;
+        continue;
+      }
+      dir = (maze_dir_t) (gen->walk[gen->cur] & kWilsonDirMask);
+      next = gen->pos;
+      StepMazePoint(&next, dir, gen->height, gen->width);
+      nidx = next.row * gen->width + next.col;
+      gen->conns[gen->cur] |= MazeDirToConn(dir);
+      gen->conns[nidx] |= MazeDirToConn(OppositeMazeDir(dir));
+      gen->walk[gen->cur] = kWilsonInTree;
+      gen->pos = next;
+      gen->cur = nidx;
+      edges++;
+    }
+  }
+  return edges;
+}
+
+bool_t IsWilsonGeneratorDone(wilson_gen_t const *gen)
+{
+  if (!gen) return true;
+  return gen->done;
+}
+
+void DrawWilsonMaze(maze_t *maze)
+{
+  wilson_gen_t *gen;
+  gen = CreateWilsonGenerator(maze);
+  StepWilsonGenerator(gen, SIZE_MAX);
+  FreeWilsonGenerator(gen);
+}
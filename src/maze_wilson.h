@@ -0,0 +1,42 @@
+/*
+ * Mazart - Wilson's Maze Generator
+ *  Module provides a Maze generator using Wilson's algorithm.  Mazes
+ *  are sampled uniformly from all spanning trees of the Maze grid.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_WILSON_H_
+#define _MAZE_WILSON_H_
+
+#include "common.h"
+#include "maze.h"
+
+/* Draws the Maze's connections using loop-erased random walks, rooted
+ * at the Maze start.  The Maze connections are expected to be cleared.
+ *
+ * Only one byte per cell is used for bookkeeping.  Early walks are
+ * long, as they wander until they hit the small initial tree, so the
+ * first part of the generation is slower than the rest. */
+void DrawWilsonMaze(maze_t *maze);
+
+/*
+ * Wilson Generator
+ *  Resumable form of DrawWilsonMaze(), the current walk is kept between
+ *  steps, whether it is still wandering or being added to the tree.
+ *  The Maze must outlive the generator, and its connections are
+ *  expected to be cleared before the first step.
+ */
+typedef struct wilson_gen_st wilson_gen_t;
+
+wilson_gen_t *CreateWilsonGenerator(maze_t *maze);
+/* Frees the generator, the Maze is left as drawn so far. */
+void FreeWilsonGenerator(wilson_gen_t *gen);
+/* Does at most `max_work` walk moves, cells scanned for the next walk
+ * and connections, so a step is bounded even while a long walk wanders
+ * and draws nothing.  Returns the number of connections drawn. */
+size_t StepWilsonGenerator(wilson_gen_t *gen, size_t max_work);
+bool_t IsWilsonGeneratorDone(wilson_gen_t const *gen);
+
+#endif /* _MAZE_WILSON_H_ */
@@ -0,0 +1,82 @@
+/*
+ * Mazart - Maze World
+ *  Module provides an endless Maze made of tiles, where any tile can be
+ *  generated on its own from a world seed and its tile coordinates.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "maze_world.h"
+
+#include "rng.h"
+
+/* Kinds of world keys, so tile streams and openings never share a
+ * stream. */
+typedef enum {
+  WORLD_KEY_TILE,
+  WORLD_KEY_SIDE_OPENING,   /* Between (tx, ty) and (tx + 1, ty). */
+  WORLD_KEY_STACK_OPENING   /* Between (tx, ty) and (tx, ty + 1). */
+} world_key_t;
+
+/* - - Maze World Internal API - - */
+
+/* Random stream of a world key. */
+static void SeedWorldRng(
+  rng_t *rng, maze_world_t const *world,
+  int64_t tx, int64_t ty, world_key_t key)
+{
+  rng_t mixer;
+  SeedRngStream(&mixer, world->seed, (uint64_t) key);
+  SeedRngStream(&mixer, NextRng(&mixer), (uint64_t) tx);
+  SeedRngStream(rng, NextRng(&mixer), (uint64_t) ty);
+}
+
+/* Offset of the opening along the shared side. */
+static size_t WorldOpeningOffset(
+  maze_world_t const *world, int64_t tx, int64_t ty, world_key_t key)
+{
+  rng_t rng;
+  SeedWorldRng(&rng, world, tx, ty, key);
+  if (key == WORLD_KEY_SIDE_OPENING)
+    return NextRngBelow(&rng, world->tile_height);
+  return NextRngBelow(&rng, world->tile_width);
+}
+
+static bool_t IsWorldValid(maze_world_t const *world)
+{
+  return world && world->tile_height > 0 && world->tile_width > 0;
+}
+
+/* - - Maze World API - - */
+
+void GetWorldTileOpenings(
+  maze_world_t const *world, int64_t tx, int64_t ty,
+  point_t openings[MAZE_DIR_COUNT])
+{
+  if (!IsWorldValid(world) || !openings) return;
+  openings[MAZE_DIR_UP].row = world->tile_height - 1;
+  openings[MAZE_DIR_UP].col =
+    WorldOpeningOffset(world, tx, ty, WORLD_KEY_STACK_OPENING);
+  openings[MAZE_DIR_DOWN].row = 0;
+  openings[MAZE_DIR_DOWN].col =
+    WorldOpeningOffset(world, tx, ty - 1, WORLD_KEY_STACK_OPENING);
+  openings[MAZE_DIR_LEFT].row =
+    WorldOpeningOffset(world, tx - 1, ty, WORLD_KEY_SIDE_OPENING);
+  openings[MAZE_DIR_LEFT].col = 0;
+  openings[MAZE_DIR_RIGHT].row =
+    WorldOpeningOffset(world, tx, ty, WORLD_KEY_SIDE_OPENING);
+  openings[MAZE_DIR_RIGHT].col = world->tile_width - 1;
+}
+
+maze_t *CreateWorldTileMaze(maze_world_t const *world, int64_t tx, int64_t ty)
+{
+  point_t openings[MAZE_DIR_COUNT];
+  rng_t rng;
+  if (!IsWorldValid(world)) return NULL;
+  GetWorldTileOpenings(world, tx, ty, openings);
+  SeedWorldRng(&rng, world, tx, ty, WORLD_KEY_TILE);
+  return CreateSeededMaze(world->tile_height, world->tile_width,
+    &openings[MAZE_DIR_LEFT], &openings[MAZE_DIR_RIGHT],
+    world->algorithm, NextRng(&rng));
+}
@@ -0,0 +1,52 @@
+/*
+ * Mazart - Maze World
+ *  Module provides an endless Maze made of tiles, where any tile can be
+ *  generated on its own from a world seed and its tile coordinates.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _MAZE_WORLD_H_
+#define _MAZE_WORLD_H_
+
+#include "common.h"
+#include "maze.h"
+
+/*
+ * Maze World Struct
+ *  Parameters of an endless Maze.  Tile (0, 0) covers the world cells
+ *  [0, tile_height) x [0, tile_width), tile column `tx` increases with
+ *  the cell column and tile row `ty` with the cell row (the "up"
+ *  direction).  Tile coordinates may be negative.
+ *
+ *  Every tile is a perfect Maze drawn from its own random stream, and
+ *  every side shared by two tiles has exactly one opening.  The
+ *  stream of a tile and the position of an opening only depend on the
+ *  world seed and the tile coordinates, so neighbouring tiles always
+ *  agree on their shared openings and each tile is made in
+ *  O(tile size).  The world is connected, but not perfect: the four
+ *  tiles around each tile corner form a loop.
+ */
+typedef struct {
+  uint64_t seed;
+  size_t tile_height;   /* Cannot be 0 */
+  size_t tile_width;    /* Cannot be 0 */
+  maze_algorithm_t algorithm;
+} maze_world_t;
+
+/* Finds the cell of tile (tx, ty) next to each of its openings,
+ * indexed by Maze Direction.  The cell next to the opening in
+ * direction `dir` is on the side of the tile facing `dir`. */
+void GetWorldTileOpenings(
+  maze_world_t const *world, int64_t tx, int64_t ty,
+  point_t openings[MAZE_DIR_COUNT]);
+
+/* Creates tile (tx, ty) as a seeded Maze of the world's tile size.
+ * The Maze start is next to the left opening and the end is next to
+ * the right opening, so solution paths of a row of tiles line up.
+ * Openings are not part of the Maze connections, see
+ * GetWorldTileOpenings().  Returns NULL if the world is invalid. */
+maze_t *CreateWorldTileMaze(maze_world_t const *world, int64_t tx, int64_t ty);
+
+#endif /* _MAZE_WORLD_H_ */
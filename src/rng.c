@@ -0,0 +1,51 @@
+/*
+ * Mazart - Random Number Generator
+ *  Module provides small, seedable random number streams.  Unlike
+ *  rand(), each stream has its own state, so streams can be used from
+ *  multiple threads and produce the same values however work is
+ *  scheduled.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "rng.h"
+
+#include <stdlib.h>
+
+void SeedRng(rng_t *rng, uint64_t seed)
+{
+  if (!rng) return;
+  rng->state = seed;
+}
+
+void SeedRngFromRand(rng_t *rng)
+{
+  uint64_t seed;
+  size_t i;
+  if (!rng) return;
+  /* rand() only guarantees 15 bits per call. */
+  seed = 0;
+  for (i = 0; i < 5; i++)
+  {
+    seed = (seed << 15) ^ (uint64_t) (rand() & 0x7FFF);
+  }
+  SeedRng(rng, seed);
+}
+
+void SplitRng(rng_t *rng, rng_t *child)
+{
+  if (!rng || !child) return;
+  SeedRng(child, NextRng(rng));
+}
+
+void SeedRngStream(rng_t *rng, uint64_t seed, uint64_t index)
+{
+  rng_t mixer;
+  if (!rng) return;
+  /* Mix the index twice so neighbouring indices give unrelated
+   * states, rather than overlapping runs of the same stream. */
+  SeedRng(&mixer, index);
+  SeedRng(&mixer, seed ^ NextRng(&mixer));
+  SeedRng(rng, NextRng(&mixer));
+}
@@ -0,0 +1,56 @@
+/*
+ * Mazart - Random Number Generator
+ *  Module provides small, seedable random number streams.  Unlike
+ *  rand(), each stream has its own state, so streams can be used from
+ *  multiple threads and produce the same values however work is
+ *  scheduled.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _RNG_H_
+#define _RNG_H_
+
+#include "common.h"
+
+/*
+ * Random Number Stream Struct
+ *  A SplitMix64 generator.  The struct is small enough to be kept by
+ *  value in any task or work item.
+ */
+typedef struct {
+  uint64_t state;
+} rng_t;
+
+/* - - Random Number Stream API - - */
+
+/* Seeds the stream. */
+void SeedRng(rng_t *rng, uint64_t seed);
+/* Seeds the stream from rand(), so the stream follows the srand()
+ * seed used by the rest of the program. */
+void SeedRngFromRand(rng_t *rng);
+/* Seeds `child` with an independent stream drawn from `rng`. */
+void SplitRng(rng_t *rng, rng_t *child);
+/* Seeds the stream numbered `index` of the family of streams given by
+ * `seed`.  Any stream of a family can be created without creating the
+ * others first (for example, one stream per row). */
+void SeedRngStream(rng_t *rng, uint64_t seed, uint64_t index);
+
+/* Next 64 random bits. */
+static inline uint64_t NextRng(rng_t *rng)
+{
+  uint64_t z;
+  z = (rng->state += UINT64_C(0x9E3779B97F4A7C15));
+  z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+  z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+  return z ^ (z >> 31);
+}
+
+/* Random value in [0, bound).  Bound must be non-zero. */
+static inline uint64_t NextRngBelow(rng_t *rng, uint64_t bound)
+{
+  return NextRng(rng) % bound;
+}
+
+#endif /* _RNG_H_ */
@@ -0,0 +1,168 @@
+/*
+ * Mazart - Thread Pool
+ *  Module provides a fixed size pool of worker threads for running
+ *  independent tasks.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#include "thread_pool.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "deque.h"
+
+/* - - Thread Count - - */
+
+static size_t gDefaultThreadCount = 0; /* 0 is processor count. */
+
+size_t DefaultThreadCount(void)
+{
+  long cpus;
+  if (gDefaultThreadCount > 0) return gDefaultThreadCount;
+  cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return cpus > 0 ? (size_t) cpus : 1;
+}
+
+void SetDefaultThreadCount(size_t threads)
+{
+  gDefaultThreadCount = threads;
+}
+
+/* - - Thread Pool Structure - - */
+
+typedef struct {
+  thread_task_t task;
+  void *arg;
+} thread_pool_item_t;
+
+struct thread_pool_st {
+  pthread_t *threads;
+  size_t thread_count;
+  deque_t *queue;
+  size_t pending;      /* Submitted tasks that have not finished. */
+  bool_t stopping;
+  pthread_mutex_t lock;
+  pthread_cond_t work_cond;  /* Signaled on new task or stopping. */
+  pthread_cond_t done_cond;  /* Signaled when pending reaches 0. */
+};
+
+/* - - Thread Pool Internal API - - */
+
+/* Set on pool worker threads. */
+static _Thread_local bool_t gIsPoolWorker = false;
+
+static void *ThreadPoolWorker(void *vpool)
+{
+  thread_pool_t *pool;
+  thread_pool_item_t *item;
+  pool = vpool;
+  gIsPoolWorker = true;
+  pthread_mutex_lock(&pool->lock);
+  while (true)
+  {
+    while (DequeSize(pool->queue) == 0 && !pool->stopping)
+    {
+      pthread_cond_wait(&pool->work_cond, &pool->lock);
+    }
+    if (DequeSize(pool->queue) == 0) break; /* Stopping */
+    item = PopDequeFirst(pool->queue);
+    pthread_mutex_unlock(&pool->lock);
+    item->task(item->arg);
+    free(item);
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->pending == 0) pthread_cond_broadcast(&pool->done_cond);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/* - - Thread Pool API - - */
+
+thread_pool_t *CreateThreadPool(size_t threads)
+{
+  thread_pool_t *pool;
+  size_t i;
+  if (gIsPoolWorker) return NULL;
+  if (threads == 0) threads = DefaultThreadCount();
+  pool = (thread_pool_t*)calloc(1, sizeof(thread_pool_t));
+  pool->threads = (pthread_t*)calloc(threads, sizeof(pthread_t));
+  pool->queue = CreateDeque();
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work_cond, NULL);
+  pthread_cond_init(&pool->done_cond, NULL);
+  for (i = 0; i < threads; i++)
+  {
+    if (pthread_create(&pool->threads[i], NULL, ThreadPoolWorker, pool)) break;
+  }
+  pool->thread_count = i;
+  if (pool->thread_count == 0)
+  {
+    FreeThreadPool(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void FreeThreadPool(thread_pool_t *pool)
+{
+  size_t i;
+  if (!pool) return;
+  WaitThreadPool(pool);
+  pthread_mutex_lock(&pool->lock);
+  pool->stopping = true;
+  pthread_cond_broadcast(&pool->work_cond);
+  pthread_mutex_unlock(&pool->lock);
+  for (i = 0; i < pool->thread_count; i++)
+  {
+    pthread_join(pool->threads[i], NULL);
+  }
+  pthread_cond_destroy(&pool->done_cond);
+  pthread_cond_destroy(&pool->work_cond);
+  pthread_mutex_destroy(&pool->lock);
+  FreeDeque(pool->queue);
+  free(pool->threads);
+  memset(pool, 0, sizeof(thread_pool_t));
+  free(pool);
+}
+
+size_t ThreadPoolSize(thread_pool_t const *pool)
+{
+  if (!pool) return 0;
+  return pool->thread_count;
+}
+
+bool_t SubmitThreadTask(thread_pool_t *pool, thread_task_t task, void *arg)
+{
+  thread_pool_item_t *item;
+  if (!pool || !task) return false;
+  item = (thread_pool_item_t*)calloc(1, sizeof(thread_pool_item_t));
+  item->task = task;
+  item->arg = arg;
+  pthread_mutex_lock(&pool->lock);
+  if (!PushDequeLast(pool->queue, item))
+  {
+    pthread_mutex_unlock(&pool->lock);
+    free(item);
+    return false;
+  }
+  pool->pending++;
+  pthread_cond_signal(&pool->work_cond);
+  pthread_mutex_unlock(&pool->lock);
+  return true;
+}
+
+void WaitThreadPool(thread_pool_t *pool)
+{
+  if (!pool) return;
+  pthread_mutex_lock(&pool->lock);
+  while (pool->pending > 0)
+  {
+    pthread_cond_wait(&pool->done_cond, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,54 @@
+/*
+ * Mazart - Thread Pool
+ *  Module provides a fixed size pool of worker threads for running
+ *  independent tasks.
+ *
+ * Copyright (c) 2019 Alex Dale
+ * This project is licensed under the terms of the MIT license.
+ * See LICENSE for details.
+ */
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include "common.h"
+
+/*
+ * Thread Pool Struct
+ *  A set of worker threads pulling tasks from a shared queue.  Tasks
+ *  may submit more tasks to the same pool.  Task arguments are not
+ *  owned by the pool.
+ */
+typedef struct thread_pool_st thread_pool_t;
+
+/* Task function type, called with the argument given on submit. */
+typedef void (*thread_task_t)(void *);
+
+/* - - Thread Count - - */
+
+/* Number of threads used by modules that create their own pools.
+ * Defaults to the number of online processors. */
+size_t DefaultThreadCount(void);
+/* Overrides the default thread count.  0 restores the processor
+ * count. */
+void SetDefaultThreadCount(size_t threads);
+
+/* - - Thread Pool API - - */
+
+/* Thread Pool constructor.  A thread count of 0 uses
+ * DefaultThreadCount().  Returns NULL when called from a Thread Pool
+ * task, so nested parallel work runs on the task's thread instead of
+ * multiplying the number of threads. */
+thread_pool_t *CreateThreadPool(size_t threads);
+/* Thread Pool destructor.  Waits for all submitted tasks first. */
+void FreeThreadPool(thread_pool_t *pool);
+
+/* Number of worker threads in the pool. */
+size_t ThreadPoolSize(thread_pool_t const *pool);
+
+/* Queues a task.  Returns true upon success. */
+bool_t SubmitThreadTask(thread_pool_t *pool, thread_task_t task, void *arg);
+/* Blocks until every submitted task, including tasks submitted by
+ * other tasks, has finished. */
+void WaitThreadPool(thread_pool_t *pool);
+
+#endif /* _THREAD_POOL_H_ */